@@ -10,12 +10,16 @@
 #ifndef BIT7Z_HPP
 #define BIT7Z_HPP
 
+#include "bitarchivecache.hpp"
 #include "bitarchiveeditor.hpp"
 #include "bitarchivereader.hpp"
+#include "bitarchivesession.hpp"
 #include "bitarchivewriter.hpp"
+#include "bitentryreader.hpp"
 #include "bitexception.hpp"
 #include "bitfilecompressor.hpp"
 #include "bitfileextractor.hpp"
+#include "bititemstream.hpp"
 #include "bitmemcompressor.hpp"
 #include "bitmemextractor.hpp"
 #include "bitstreamcompressor.hpp"
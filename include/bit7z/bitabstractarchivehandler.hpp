@@ -55,10 +55,24 @@ enum struct OverwriteMode {
     None = 0, ///< The handler will throw an exception if the output file or buffer already exists.
     Overwrite, ///< The handler will overwrite the old file or buffer with the new one.
     Skip, ///< The handler will skip writing to the output file or buffer.
+    SkipIfUnchanged, ///< When extracting to the filesystem, the handler will skip the items whose output file already
+                     ///< exists with the same size and modified time (seconds precision), without decoding them, and it
+                     ///< will overwrite the other ones; in all the other cases, it behaves like Overwrite.
+    SkipIfUnchangedCrc, ///< Like SkipIfUnchanged, but the CRC of the existing output file must also match
+                        ///< the one of the item (if the archive provides it).
 //TODO:    RenameOutput,
 //TODO:    RenameExisting
 };
 
+/**
+ * @brief Enumeration representing how the archive handler should behave when the extraction of an item fails.
+ */
+enum struct ErrorPolicy {
+    Abort,   ///< The extraction stops at the first item that fails, throwing its error.
+    Continue ///< The items that fail are skipped, and their errors are thrown all together
+             ///< at the end of the extraction.
+};
+
 /**
  * @brief Enumeration representing the policy according to which the archive handler should treat
  *        the items that match the pattern given by the user.
@@ -139,6 +153,40 @@ class BitAbstractArchiveHandler {
          */
         BIT7Z_NODISCARD auto overwriteMode() const -> OverwriteMode;
 
+        /**
+         * @return the number of threads used for writing the extracted files to the filesystem
+         *         (zero if the files are written by the decoding thread).
+         */
+        BIT7Z_NODISCARD auto writerThreads() const noexcept -> uint32_t;
+
+        /**
+         * @return the maximum amount of memory (in bytes) used for buffering the decoded files
+         *         waiting to be written by the writer threads.
+         */
+        BIT7Z_NODISCARD auto writerMemoryLimit() const noexcept -> uint64_t;
+
+        /**
+         * @return a boolean value indicating whether the extracted files are written as sparse files.
+         */
+        BIT7Z_NODISCARD auto sparseExtraction() const noexcept -> bool;
+
+        /**
+         * @return the minimum size (in bytes) of the files extracted via memory-mapped output files
+         *         (zero if memory-mapped extraction is disabled).
+         */
+        BIT7Z_NODISCARD auto memoryMappedThreshold() const noexcept -> uint64_t;
+
+        /**
+         * @return the current ErrorPolicy.
+         */
+        BIT7Z_NODISCARD auto errorPolicy() const noexcept -> ErrorPolicy;
+
+        /**
+         * @return the path of the journal used for resuming the extractions to the filesystem
+         *         (empty if no journal is used).
+         */
+        BIT7Z_NODISCARD auto extractionJournal() const -> tstring;
+
         /**
          * @brief Sets up a password to be used by the archive handler.
          *
@@ -225,6 +273,85 @@ class BitAbstractArchiveHandler {
          */
         void setOverwriteMode( OverwriteMode mode );
 
+        /**
+         * @brief Sets the number of threads used for writing the extracted files to the filesystem.
+         *
+         * When greater than zero, the decoded content of the files that fit in the writer memory limit is
+         * buffered in memory and handed over to a pool of writer threads, which create, write, and close
+         * the output files in parallel with the decoding.
+         * This is useful for archives containing many small files, especially on filesystems
+         * with a high per-file latency (e.g., network filesystems).
+         *
+         * @note Errors raised by the writer threads are reported in the order of the archive items.
+         *
+         * @param threadsCount  the number of writer threads (zero disables the writer pool).
+         */
+        void setWriterThreads( uint32_t threadsCount ) noexcept;
+
+        /**
+         * @brief Sets the maximum amount of memory used for buffering the decoded files waiting to be written
+         *        by the writer threads.
+         *
+         * @note Files bigger than this limit are always written directly by the decoding thread.
+         *
+         * @param memoryLimit  the maximum amount of memory (in bytes) used by the writer pool.
+         */
+        void setWriterMemoryLimit( uint64_t memoryLimit ) noexcept;
+
+        /**
+         * @brief Sets whether the extracted files must be written as sparse files.
+         *
+         * When enabled, the blocks of the extracted files containing only zeros are not written,
+         * but skipped over, leaving holes in the output files (e.g., useful for virtual machine disk images).
+         *
+         * @note Sparse files are supported only on POSIX systems; on Windows, this setting is ignored.
+         *
+         * @param sparse  if true, the extracted files will be written as sparse files.
+         */
+        void setSparseExtraction( bool sparse ) noexcept;
+
+        /**
+         * @brief Sets the minimum size of the files to be extracted via memory-mapped output files.
+         *
+         * The output files of the items whose size is at least the given threshold are created at their final size
+         * and mapped in memory, so that the decoded content is copied directly into the mapping, rather than
+         * being written via system calls, and the kernel writes it back lazily (e.g., useful for multi-GB items).
+         *
+         * @note Memory-mapped output files are supported only on Linux; elsewhere, this setting is ignored.
+         *       The setting is also ignored for the sparse extraction, and for the files written by the writer pool.
+         *
+         * @param threshold  the minimum size (in bytes) of the memory-mapped output files
+         *                   (zero, the default, disables the memory-mapped extraction).
+         */
+        void setMemoryMappedThreshold( uint64_t threshold ) noexcept;
+
+        /**
+         * @brief Sets how the handler should behave when the extraction of an item fails.
+         *
+         * When using ErrorPolicy::Continue, an item that fails (e.g., because of a CRC error, or because its output
+         * file cannot be created or written) is skipped, and the extraction goes on with the next items;
+         * at the end, a single BitException is thrown, whose failedFiles() are the paths of the failed items
+         * with the corresponding error codes.
+         *
+         * @param policy  the ErrorPolicy to be used by the handler.
+         */
+        void setErrorPolicy( ErrorPolicy policy ) noexcept;
+
+        /**
+         * @brief Sets the path of the journal used for resuming the extractions to the filesystem.
+         *
+         * While extracting an archive to a directory, each file is recorded in the journal (with its size and CRC)
+         * as soon as it has been completely extracted. If the extraction is interrupted (e.g., the process is killed),
+         * extracting the archive again with the same journal skips the files that it records as completed,
+         * as long as their output files still have the recorded size; solid blocks containing only completed
+         * files are not decoded at all. The journal is deleted once the extraction completes successfully.
+         *
+         * @note The journal tracks the extraction of a single archive to a single directory.
+         *
+         * @param journalPath  the path of the journal file (an empty path disables the journal).
+         */
+        void setExtractionJournal( const tstring& journalPath );
+
     protected:
         explicit BitAbstractArchiveHandler( const Bit7zLibrary& lib,
                                             tstring password = {},
@@ -235,6 +362,12 @@ class BitAbstractArchiveHandler {
         tstring mPassword;
         bool mRetainDirectories;
         OverwriteMode mOverwriteMode;
+        uint32_t mWriterThreads;
+        uint64_t mWriterMemoryLimit;
+        bool mSparseExtraction;
+        uint64_t mMemoryMappedThreshold;
+        ErrorPolicy mErrorPolicy;
+        tstring mExtractionJournal;
 
         //CALLBACKS
         TotalCallback mTotalCallback;
@@ -0,0 +1,204 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITARCHIVECACHE_HPP
+#define BITARCHIVECACHE_HPP
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "bitarchivereader.hpp"
+
+namespace bit7z {
+
+class BitArchiveReaderPool;
+
+/**
+ * @brief An exclusive lease on an archive reader opened by a BitArchiveCache.
+ *
+ * A reader is used by a single lease at a time, so that different threads can use their leases concurrently,
+ * even on the same archive. When the lease ends, its reader goes back to the cache, to be reused by the following
+ * leases of the same archive (unless the archive has been evicted from the cache, in which case it is closed).
+ */
+class BitArchiveLease final {
+    public:
+        BitArchiveLease( const BitArchiveLease& ) = delete;
+
+        BitArchiveLease( BitArchiveLease&& other ) noexcept;
+
+        auto operator=( const BitArchiveLease& ) -> BitArchiveLease& = delete;
+
+        auto operator=( BitArchiveLease&& other ) noexcept -> BitArchiveLease&;
+
+        ~BitArchiveLease();
+
+        /**
+         * @return the leased archive reader.
+         */
+        BIT7Z_NODISCARD auto reader() const noexcept -> const BitArchiveReader&;
+
+        BIT7Z_NODISCARD auto operator*() const noexcept -> const BitArchiveReader&;
+
+        BIT7Z_NODISCARD auto operator->() const noexcept -> const BitArchiveReader*;
+
+    private:
+        std::shared_ptr< BitArchiveReaderPool > mPool;
+        std::unique_ptr< BitArchiveReader > mReader;
+
+        BitArchiveLease( std::shared_ptr< BitArchiveReaderPool > pool, std::unique_ptr< BitArchiveReader > reader );
+
+        void release() noexcept;
+
+        friend class BitArchiveCache;
+};
+
+/**
+ * @brief The BitArchiveCache class is a thread-safe cache of opened archives, so that opening the same archive
+ *        again doesn't need to reopen the file, detect its format, and parse its headers.
+ *
+ * The archives are identified by their (canonical) path, size, last modified time, format, and (the hash of)
+ * the password used for opening them: if the file on disk changes, the next lease opens it again.
+ * The cache keeps the readers not currently leased: a lease reuses one of them, if any, or opens a new one.
+ * When the cache exceeds its maximum number of archives or its memory budget, the least recently used archives
+ * are evicted.
+ *
+ * @note Usually, a program needs a single cache, shared by all its threads.
+ */
+class BitArchiveCache final {
+    public:
+        /**
+         * @brief The default maximum number of archives kept open by the cache.
+         */
+        static constexpr std::size_t kDefaultMaxArchives = 256;
+
+        /**
+         * @brief The default memory budget of the cache (256 MiB).
+         */
+        static constexpr uint64_t kDefaultMemoryBudget = 256ull * 1024ull * 1024ull;
+
+        /**
+         * @brief Constructs an empty cache of archives.
+         *
+         * @param lib           the 7z library used to open the archives.
+         * @param maxArchives   the maximum number of archives kept open by the cache.
+         * @param memoryBudget  the (estimated) memory that can be used by the archives kept open by the cache.
+         */
+        explicit BitArchiveCache( const Bit7zLibrary& lib,
+                                  std::size_t maxArchives = kDefaultMaxArchives,
+                                  uint64_t memoryBudget = kDefaultMemoryBudget );
+
+        BitArchiveCache( const BitArchiveCache& ) = delete;
+
+        BitArchiveCache( BitArchiveCache&& ) = delete;
+
+        auto operator=( const BitArchiveCache& ) -> BitArchiveCache& = delete;
+
+        auto operator=( BitArchiveCache&& ) -> BitArchiveCache& = delete;
+
+        ~BitArchiveCache() = default;
+
+        /**
+         * @brief Leases a reader of the given archive, opening it only if no reader of the archive is idle
+         *        in the cache.
+         *
+         * @param inArchive the path to the archive to be opened.
+         * @param format    the format of the archive.
+         * @param password  the password needed for opening the archive.
+         *
+         * @return the lease on the opened archive.
+         */
+        BIT7Z_NODISCARD auto lease( const tstring& inArchive,
+                                    const BitInFormat& format BIT7Z_DEFAULT_FORMAT,
+                                    const tstring& password = {} ) -> BitArchiveLease;
+
+        /**
+         * @brief Removes all the archives from the cache (the leased readers stay open until their leases end).
+         */
+        void clear();
+
+        /**
+         * @return the number of archives in the cache.
+         */
+        BIT7Z_NODISCARD auto size() const -> std::size_t;
+
+        /**
+         * @return the estimated memory used by the idle readers in the cache.
+         */
+        BIT7Z_NODISCARD auto memoryUsage() const -> uint64_t;
+
+        /**
+         * @return the number of leases that reused an idle reader in the cache.
+         */
+        BIT7Z_NODISCARD auto hits() const -> uint64_t;
+
+        /**
+         * @return the number of leases that had to open a new reader of their archive.
+         */
+        BIT7Z_NODISCARD auto misses() const -> uint64_t;
+
+        /**
+         * @brief Sets the maximum number of archives kept open by the cache, evicting the exceeding ones.
+         *
+         * @param maxArchives the maximum number of archives.
+         */
+        void setMaxArchives( std::size_t maxArchives );
+
+        /**
+         * @brief Sets the memory budget of the cache, evicting the archives exceeding it.
+         *
+         * @note The memory used by an archive is estimated from the number of its items.
+         *
+         * @param memoryBudget the memory budget, in bytes.
+         */
+        void setMemoryBudget( uint64_t memoryBudget );
+
+    private:
+        struct ArchiveKey {
+            tstring path;
+            uint64_t size;
+            int64_t modifiedTime;
+            unsigned char format;
+            std::size_t passwordHash;
+
+            auto operator==( const ArchiveKey& other ) const noexcept -> bool;
+        };
+
+        struct ArchiveKeyHash {
+            auto operator()( const ArchiveKey& key ) const noexcept -> std::size_t;
+        };
+
+        struct CachedArchive {
+            ArchiveKey key;
+            std::shared_ptr< BitArchiveReaderPool > readers;
+        };
+
+        using LruList = std::list< CachedArchive >;
+
+        const Bit7zLibrary& mLibrary;
+        std::size_t mMaxArchives;
+        uint64_t mMemoryBudget;
+
+        mutable std::mutex mMutex;
+        LruList mArchives; // Most recently used first.
+        std::unordered_map< ArchiveKey, LruList::iterator, ArchiveKeyHash > mArchivesIndex;
+        uint64_t mHits;
+        uint64_t mMisses;
+
+        // Note: the following methods must be called while holding the mutex.
+        BIT7Z_NODISCARD auto currentMemoryUsage() const -> uint64_t;
+
+        void evict();
+};
+
+}  // namespace bit7z
+
+#endif // BITARCHIVECACHE_HPP
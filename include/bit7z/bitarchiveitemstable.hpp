@@ -0,0 +1,186 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITARCHIVEITEMSTABLE_HPP
+#define BITARCHIVEITEMSTABLE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "bitdefines.hpp"
+#include "bitformat.hpp"
+#include "bitpropvariant.hpp"
+#include "bittypes.hpp"
+
+namespace bit7z {
+
+class BitInputArchive;
+
+/**
+ * @brief The ItemsTableColumns enum specifies which item properties are loaded in a BitArchiveItemsTable.
+ *
+ * @note The directory flag of each item is always loaded.
+ */
+enum struct ItemsTableColumns : unsigned {
+    Path = 1u << 0,         ///< The path of the items (stored in a single string arena)
+    Size = 1u << 1,         ///< The uncompressed size of the items
+    PackSize = 1u << 2,     ///< The compressed size of the items
+    ModifiedTime = 1u << 3, ///< The last write time of the items
+    Crc = 1u << 4,          ///< The CRC of the items
+    Attributes = 1u << 5,   ///< The attributes of the items
+    Encrypted = 1u << 6,    ///< Whether the items are encrypted
+    All = ( 1u << 7 ) - 1u  ///< All the above columns
+};
+
+inline constexpr auto operator|( ItemsTableColumns lhs, ItemsTableColumns rhs ) noexcept -> ItemsTableColumns {
+    return static_cast< ItemsTableColumns >( to_underlying( lhs ) | to_underlying( rhs ) );
+}
+
+using ItemsTableColumnsType = underlying_type_t< ItemsTableColumns >;
+
+inline constexpr auto operator&( ItemsTableColumns lhs, ItemsTableColumns rhs ) noexcept -> ItemsTableColumnsType {
+    return to_underlying( lhs ) & to_underlying( rhs );
+}
+
+/**
+ * @brief The BitArchiveItemsTable class is a compact, column-oriented snapshot of the metadata of an archive's items.
+ *
+ * Each column is a contiguous array indexed by the item index; the paths of the items are stored
+ * one after the other in a single string arena. Columns that were not requested are empty.
+ */
+class BitArchiveItemsTable final {
+    public:
+        /**
+         * @return the columns loaded in the table.
+         */
+        BIT7Z_NODISCARD auto columns() const noexcept -> ItemsTableColumns;
+
+        /**
+         * @return the number of items (i.e., rows) in the table.
+         */
+        BIT7Z_NODISCARD auto itemsCount() const noexcept -> uint32_t;
+
+        /**
+         * @return true if and only if the item at the given index is a directory.
+         */
+        BIT7Z_NODISCARD auto isDir( uint32_t index ) const -> bool;
+
+        /**
+         * @return the path of the item at the given index.
+         */
+        BIT7Z_NODISCARD auto path( uint32_t index ) const -> tstring;
+
+        /**
+         * @return a pointer to the path of the item at the given index in the paths arena
+         *         (note: the path is not null-terminated, its length is given by pathLength).
+         */
+        BIT7Z_NODISCARD auto pathData( uint32_t index ) const -> const tchar*;
+
+        /**
+         * @return the length of the path of the item at the given index.
+         */
+        BIT7Z_NODISCARD auto pathLength( uint32_t index ) const -> std::size_t;
+
+        /**
+         * @return the uncompressed size of the item at the given index.
+         */
+        BIT7Z_NODISCARD auto size( uint32_t index ) const -> uint64_t;
+
+        /**
+         * @return the compressed size of the item at the given index.
+         */
+        BIT7Z_NODISCARD auto packSize( uint32_t index ) const -> uint64_t;
+
+        /**
+         * @return true if and only if the last write time of the item at the given index is available.
+         */
+        BIT7Z_NODISCARD auto hasLastWriteTime( uint32_t index ) const -> bool;
+
+        /**
+         * @return the last write time of the item at the given index.
+         */
+        BIT7Z_NODISCARD auto lastWriteTime( uint32_t index ) const -> time_type;
+
+        /**
+         * @return true if and only if the CRC of the item at the given index is available.
+         */
+        BIT7Z_NODISCARD auto hasCrc( uint32_t index ) const -> bool;
+
+        /**
+         * @return the CRC of the item at the given index (zero if not available).
+         */
+        BIT7Z_NODISCARD auto crc( uint32_t index ) const -> uint32_t;
+
+        /**
+         * @return the attributes of the item at the given index.
+         */
+        BIT7Z_NODISCARD auto attributes( uint32_t index ) const -> uint32_t;
+
+        /**
+         * @return true if and only if the item at the given index is encrypted.
+         */
+        BIT7Z_NODISCARD auto isEncrypted( uint32_t index ) const -> bool;
+
+        /**
+         * @return the uncompressed sizes column.
+         */
+        BIT7Z_NODISCARD auto sizes() const noexcept -> const std::vector< uint64_t >&;
+
+        /**
+         * @return the compressed sizes column.
+         */
+        BIT7Z_NODISCARD auto packSizes() const noexcept -> const std::vector< uint64_t >&;
+
+        /**
+         * @return the CRCs column.
+         */
+        BIT7Z_NODISCARD auto crcs() const noexcept -> const std::vector< uint32_t >&;
+
+        /**
+         * @return the attributes column.
+         */
+        BIT7Z_NODISCARD auto attributesColumn() const noexcept -> const std::vector< uint32_t >&;
+
+    private:
+        ItemsTableColumns mColumns;
+        uint32_t mItemsCount;
+
+        tstring mPathsArena;
+        std::vector< std::size_t > mPathOffsets; // itemsCount + 1 offsets in the paths arena.
+
+        std::vector< uint64_t > mSizes;
+        std::vector< uint64_t > mPackSizes;
+        std::vector< time_type > mLastWriteTimes;
+        std::vector< uint32_t > mCrcs;
+        std::vector< uint32_t > mAttributes;
+
+        // Flags bitsets
+        std::vector< bool > mIsDir;
+        std::vector< bool > mHasLastWriteTime;
+        std::vector< bool > mHasCrc;
+        std::vector< bool > mIsEncrypted;
+
+        /* BitArchiveItemsTable objects can be created only by BitArchiveReader and BitPrefetchedItems */
+        BitArchiveItemsTable( ItemsTableColumns columns, uint32_t itemsCount );
+
+        void addItem( const BitInputArchive& archive, uint32_t index );
+
+        // Removes all the rows, keeping the allocated memory for reuse.
+        void clear() noexcept;
+
+        void checkIndex( uint32_t index ) const;
+
+        friend class BitArchiveReader;
+
+        friend class BitPrefetchedItems;
+};
+
+}  // namespace bit7z
+
+#endif // BITARCHIVEITEMSTABLE_HPP
@@ -10,8 +10,13 @@
 #ifndef BITARCHIVEREADER_HPP
 #define BITARCHIVEREADER_HPP
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 #include "bitabstractarchiveopener.hpp"
 #include "bitarchiveiteminfo.hpp"
+#include "bitarchiveitemstable.hpp"
 #include "bitexception.hpp"
 #include "bitinputarchive.hpp"
 
@@ -21,6 +26,28 @@ struct IArchiveExtractCallback;
 
 namespace bit7z {
 
+/**
+ * @brief Aggregated statistics about a group of files in an archive.
+ */
+struct BitItemsStats {
+    uint32_t filesCount{ 0 }; ///< The number of files in the group.
+    uint64_t size{ 0 };       ///< The total uncompressed size of the files in the group.
+    uint64_t packSize{ 0 };   ///< The total compressed size of the files in the group.
+};
+
+/**
+ * @brief Summary statistics about the content of an archive, computed in a single pass over its items.
+ */
+struct BitArchiveSummary {
+    uint32_t foldersCount{ 0 };             ///< The number of folders in the archive.
+    uint32_t filesCount{ 0 };               ///< The number of files in the archive.
+    uint32_t encryptedFilesCount{ 0 };      ///< The number of encrypted files in the archive.
+    uint64_t size{ 0 };                     ///< The total uncompressed size of the archive's files.
+    uint64_t packSize{ 0 };                 ///< The total compressed size of the archive's files.
+    std::map< tstring, BitItemsStats > methods;    ///< The statistics of the files, by compression method.
+    std::map< tstring, BitItemsStats > extensions; ///< The statistics of the files, by extension.
+};
+
 /**
  * @brief The BitArchiveReader class allows reading metadata of archives, as well as extracting them.
  */
@@ -143,6 +170,24 @@ class BitArchiveReader final : public BitAbstractArchiveOpener, public BitInputA
                           const BitInFormat& format BIT7Z_DEFAULT_FORMAT,
                           const tstring& password = {} );
 
+        /**
+         * @brief Constructs a BitArchiveReader object, opening the archive stored as an item of another archive,
+         *        without extracting it first.
+         *
+         * @note The parent archive must outlive the constructed reader.
+         *
+         * @param lib           the 7z library used.
+         * @param parentArchive the archive containing the archive to be read.
+         * @param index         the index of the item of the parent archive containing the archive to be read.
+         * @param format        the format of the input archive.
+         * @param password      (optional) the password needed for opening the input archive.
+         */
+        BitArchiveReader( const Bit7zLibrary& lib,
+                          const BitInputArchive& parentArchive,
+                          uint32_t index,
+                          const BitInFormat& format BIT7Z_DEFAULT_FORMAT,
+                          const tstring& password = {} );
+
         BitArchiveReader( const BitArchiveReader& ) = delete;
 
         BitArchiveReader( BitArchiveReader&& ) = delete;
@@ -168,6 +213,30 @@ class BitArchiveReader final : public BitAbstractArchiveOpener, public BitInputA
          */
         BIT7Z_NODISCARD auto items() const -> vector< BitArchiveItemInfo >;
 
+        /**
+         * @brief Reads the metadata of all the archive items into a compact column-oriented table.
+         *
+         * Differently from items(), only the properties needed by the requested columns are read,
+         * and no per-item map of properties is allocated: this is the preferred way to list big archives.
+         *
+         * @param columns  the item properties to be loaded in the table.
+         *
+         * @return a BitArchiveItemsTable containing the requested metadata of all the archive items.
+         */
+        BIT7Z_NODISCARD auto itemsTable( ItemsTableColumns columns = ItemsTableColumns::All ) const
+            -> BitArchiveItemsTable;
+
+        /**
+         * @brief Computes (only once) the summary statistics about the archive's content.
+         *
+         * @note The summary is computed the first time it is needed (by this or any of the functions
+         *       foldersCount, filesCount, size, packSize, hasEncryptedItems, and isEncrypted),
+         *       and it is cached, so subsequent calls take constant time.
+         *
+         * @return the summary statistics about the archive's content.
+         */
+        BIT7Z_NODISCARD auto summary() const -> const BitArchiveSummary&;
+
         /**
          * @return the number of folders contained in the archive.
          */
@@ -267,6 +336,9 @@ class BitArchiveReader final : public BitAbstractArchiveOpener, public BitInputA
         }
 
     private:
+        mutable std::unique_ptr< BitArchiveSummary > mSummary;
+        mutable std::mutex mSummaryMutex;
+
         static auto isOpenEncryptedError( std::error_code error ) -> bool;
 };
 
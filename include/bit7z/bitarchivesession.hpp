@@ -0,0 +1,130 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITARCHIVESESSION_HPP
+#define BITARCHIVESESSION_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "bitarchiveitemstable.hpp"
+#include "bitarchivereader.hpp"
+
+namespace bit7z {
+
+/**
+ * @brief The BitArchiveSession class allows multiple threads to read the same archive file concurrently.
+ *
+ * The metadata of the archive's items is read once, when the session is created, and it can be accessed
+ * by any thread. Each extraction uses an archive reader (i.e., file stream and decoders) not used by
+ * any other thread at the same time: the readers are opened lazily, when all the already opened ones are busy,
+ * and they are reused by the following extractions.
+ */
+class BitArchiveSession final {
+    public:
+        /**
+         * @brief Constructs a session for reading the given archive file.
+         *
+         * @param lib       the 7z library used.
+         * @param inArchive the path to the archive to be read.
+         * @param format    the format of the input archive.
+         * @param password  the password needed for opening the input archive.
+         */
+        BitArchiveSession( const Bit7zLibrary& lib,
+                           const tstring& inArchive,
+                           const BitInFormat& format BIT7Z_DEFAULT_FORMAT,
+                           const tstring& password = {} );
+
+        BitArchiveSession( const BitArchiveSession& ) = delete;
+
+        BitArchiveSession( BitArchiveSession&& ) = delete;
+
+        auto operator=( const BitArchiveSession& ) -> BitArchiveSession& = delete;
+
+        auto operator=( BitArchiveSession&& ) -> BitArchiveSession& = delete;
+
+        ~BitArchiveSession();
+
+        /**
+         * @return the path to the archive file.
+         */
+        BIT7Z_NODISCARD auto archivePath() const noexcept -> const tstring&;
+
+        /**
+         * @return the number of items in the archive.
+         */
+        BIT7Z_NODISCARD auto itemsCount() const noexcept -> uint32_t;
+
+        /**
+         * @return the metadata of the archive's items, read when the session was created.
+         */
+        BIT7Z_NODISCARD auto items() const noexcept -> const BitArchiveItemsTable&;
+
+        /**
+         * @return the number of archive readers opened by the session so far.
+         */
+        BIT7Z_NODISCARD auto readersCount() const -> std::size_t;
+
+        /**
+         * @brief Extracts the specified item to the given buffer.
+         *
+         * @param outBuffer the output buffer where the content of the item will be put.
+         * @param index     the index of the item to be extracted.
+         */
+        void extractTo( std::vector< byte_t >& outBuffer, uint32_t index ) const;
+
+        /**
+         * @brief Extracts the specified item to the given pre-allocated buffer.
+         *
+         * @param buffer the output buffer where the content of the item will be put.
+         * @param size   the size of the output buffer (it must be equal to the unpacked size of the item).
+         * @param index  the index of the item to be extracted.
+         */
+        void extractTo( byte_t* buffer, std::size_t size, uint32_t index ) const;
+
+        /**
+         * @brief Extracts the specified item to the given output stream.
+         *
+         * @param outStream the (binary) stream where the content of the item will be written.
+         * @param index     the index of the item to be extracted.
+         */
+        void extractTo( std::ostream& outStream, uint32_t index ) const;
+
+        /**
+         * @brief Extracts the specified items to the chosen directory.
+         *
+         * @param outDir  the output directory where the extracted files will be put.
+         * @param indices the array of indices of the files in the archive that must be extracted.
+         */
+        void extractTo( const tstring& outDir, const std::vector< uint32_t >& indices ) const;
+
+    private:
+        const Bit7zLibrary& mLibrary;
+        const tstring mArchivePath;
+        const BitInFormat& mFormat;
+        const tstring mPassword;
+
+        // The metadata is immutable after construction, so it can be read concurrently without locking.
+        std::unique_ptr< BitArchiveItemsTable > mItems;
+
+        mutable std::mutex mReadersMutex;
+        mutable std::vector< std::unique_ptr< BitArchiveReader > > mIdleReaders;
+        mutable std::size_t mReadersCount;
+
+        class ReaderLease;
+
+        BIT7Z_NODISCARD auto openReader() const -> std::unique_ptr< BitArchiveReader >;
+};
+
+}  // namespace bit7z
+
+#endif // BITARCHIVESESSION_HPP
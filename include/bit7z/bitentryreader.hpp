@@ -0,0 +1,135 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITENTRYREADER_HPP
+#define BITENTRYREADER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "bitdefines.hpp"
+#include "bitinputarchive.hpp"
+#include "bittypes.hpp"
+
+namespace bit7z {
+
+/**
+ * @brief The metadata of the entry being read by a BitEntryReader.
+ */
+struct BitArchiveEntry {
+    uint32_t index;           ///< The index of the item in the archive.
+    tstring path;             ///< The path of the item in the archive.
+    uint64_t size;            ///< The unpacked size of the item.
+    uint64_t packSize;        ///< The compressed size of the item.
+    uint32_t crc;             ///< The CRC value of the item.
+    uint32_t attributes;      ///< The attributes of the item.
+    time_type lastWriteTime;  ///< The last write time of the item.
+    bool isEncrypted;         ///< Whether the item is encrypted.
+};
+
+/**
+ * @brief The BitEntryReader class reads the files of an archive one after the other, in the archive order,
+ *        pulling their decoded content on demand.
+ *
+ * The extraction runs on a worker thread, which hands the decoded content over through a small bounded buffer:
+ * the memory used doesn't depend on the size of the items, and the extraction advances only as the content is read.
+ * The content of an entry that is not read completely is decoded and discarded when moving to the next entry.
+ *
+ * @note The input archive must outlive the reader, and it must not be used by other extractions while being read.
+ *       A reader must be used by a single thread at a time.
+ */
+class BitEntryReader final {
+    public:
+        static constexpr auto kDefaultBufferSize = static_cast< std::size_t >( 256 * 1024 );
+
+        /**
+         * @brief Constructs a reader for the files of the given archive.
+         *
+         * @param inputArchive the archive to be read.
+         * @param bufferSize   the size of the buffer used to hand over the decoded content.
+         */
+        explicit BitEntryReader( const BitInputArchive& inputArchive, std::size_t bufferSize = kDefaultBufferSize );
+
+        BitEntryReader( const BitEntryReader& ) = delete;
+
+        BitEntryReader( BitEntryReader&& ) = delete;
+
+        auto operator=( const BitEntryReader& ) -> BitEntryReader& = delete;
+
+        auto operator=( BitEntryReader&& ) -> BitEntryReader& = delete;
+
+        ~BitEntryReader();
+
+        /**
+         * @brief Moves to the next file entry of the archive, skipping the unread content of the current one.
+         *
+         * @return true if there is a next entry, false if all the entries have been read.
+         */
+        auto nextEntry() -> bool;
+
+        /**
+         * @return the metadata of the current entry (valid only after nextEntry() returned true).
+         */
+        BIT7Z_NODISCARD auto entry() const noexcept -> const BitArchiveEntry&;
+
+        /**
+         * @brief Reads the next chunk of the decoded content of the current entry.
+         *
+         * The call blocks until some content is available or the entry ends.
+         *
+         * @param buffer the buffer where the content will be put.
+         * @param size   the size of the buffer.
+         *
+         * @return the number of bytes read, which is zero only when the content of the entry ended.
+         */
+        auto read( byte_t* buffer, std::size_t size ) -> std::size_t;
+
+        /**
+         * @brief Stops the extraction, discarding the remaining entries.
+         */
+        void close() noexcept;
+
+    private:
+        const BitInputArchive& mInputArchive;
+        BitArchiveEntry mEntry;
+
+        std::mutex mMutex;
+        std::condition_variable mReaderCondition;
+        std::condition_variable mWorkerCondition;
+        std::thread mWorker;
+
+        // Ring buffer handing over the decoded content of the current entry.
+        buffer_t mBuffer;
+        std::size_t mBufferHead;
+        std::size_t mBufferUsed;
+
+        uint64_t mRequestedEntries; // Number of entries requested by nextEntry() so far.
+        uint64_t mStartedEntries;   // Number of entries whose extraction started so far.
+        bool mEntryFinished;
+        bool mExtractionFinished;
+        bool mClosed;
+        std::exception_ptr mExtractionError;
+
+        class EntrySink;
+
+        void extractEntries();
+
+        BIT7Z_NODISCARD auto startEntry( const BitArchiveItemOffset& item ) -> bool;
+
+        BIT7Z_NODISCARD auto writeContent( const byte_t* data, std::size_t size ) -> bool;
+
+        void finishEntry();
+};
+
+}  // namespace bit7z
+
+#endif // BITENTRYREADER_HPP
@@ -0,0 +1,90 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITEXTRACTIONARENA_HPP
+#define BITEXTRACTIONARENA_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "bitdefines.hpp"
+#include "bittypes.hpp"
+
+namespace bit7z {
+
+/**
+ * @brief An item extracted to a BitExtractionArena.
+ */
+struct BitArenaEntry {
+    uint32_t index;         ///< The index of the item in the archive.
+    std::size_t pathOffset; ///< The offset of the item's path in the arena's paths.
+    std::size_t pathLength; ///< The length of the item's path.
+    std::size_t offset;     ///< The offset of the item's content in the arena's data.
+    std::size_t size;       ///< The size of the item's content.
+};
+
+/**
+ * @brief The BitExtractionArena class holds the content of many extracted items in a single contiguous buffer,
+ *        and their paths in a single string, indexed by a compact vector of entries.
+ *
+ * The data buffer is allocated only once, with the total size of the extracted items.
+ */
+class BitExtractionArena final {
+    public:
+        /**
+         * @return the number of items in the arena.
+         */
+        BIT7Z_NODISCARD auto itemsCount() const noexcept -> std::size_t;
+
+        /**
+         * @return the entries of the items in the arena, in the order they were requested.
+         */
+        BIT7Z_NODISCARD auto entries() const noexcept -> const std::vector< BitArenaEntry >&;
+
+        /**
+         * @return the buffer holding the content of all the items in the arena.
+         */
+        BIT7Z_NODISCARD auto data() const noexcept -> const buffer_t&;
+
+        /**
+         * @return the string holding the paths of all the items in the arena, one after the other.
+         */
+        BIT7Z_NODISCARD auto paths() const noexcept -> const tstring&;
+
+        /**
+         * @return the path of the item of the given entry.
+         */
+        BIT7Z_NODISCARD auto path( const BitArenaEntry& entry ) const -> tstring;
+
+        /**
+         * @return a pointer to the (not null-terminated) path of the item of the given entry.
+         */
+        BIT7Z_NODISCARD auto pathData( const BitArenaEntry& entry ) const noexcept -> const tchar*;
+
+        /**
+         * @return a pointer to the content of the item of the given entry.
+         */
+        BIT7Z_NODISCARD auto itemData( const BitArenaEntry& entry ) const noexcept -> const byte_t*;
+
+        /**
+         * @brief Removes all the items from the arena.
+         */
+        void clear() noexcept;
+
+    private:
+        buffer_t mData;
+        tstring mPaths;
+        std::vector< BitArenaEntry > mEntries;
+
+        friend class ArenaExtractCallback;
+};
+
+}  // namespace bit7z
+
+#endif // BITEXTRACTIONARENA_HPP
@@ -238,7 +238,7 @@ class BitExtractor final : public BitAbstractArchiveOpener {
             vector< uint32_t > matchedIndices;
             const bool shouldExtractMatchedItems = policy == FilterPolicy::Include;
             // Searching for files inside the archive that match the given filter
-            for ( const auto& item : inputArchive ) {
+            for ( const auto& item : inputArchive.prefetchedItems( ItemsTableColumns::Path ) ) {
                 const bool itemMatches = filter( item.path() );
                 if ( itemMatches == shouldExtractMatchedItems ) {
                     /* The if-condition is equivalent to an exclusive XNOR (negated XOR) between
@@ -265,7 +265,7 @@ class BitExtractor final : public BitAbstractArchiveOpener {
 
             const bool shouldExtractMatchedItem = policy == FilterPolicy::Include;
             // Searching for files inside the archive that match the given filter
-            for ( const auto& item : inputArchive ) {
+            for ( const auto& item : inputArchive.prefetchedItems( ItemsTableColumns::Path ) ) {
                 const bool itemMatches = filter( item.path() );
                 if ( itemMatches == shouldExtractMatchedItem ) {
                     /* The if-condition is equivalent to an exclusive NOR (negated XOR) between
@@ -10,12 +10,21 @@
 #define BITINPUTARCHIVE_HPP
 
 #include <array>
+#include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
 
 #include "bitabstractarchivehandler.hpp"
 #include "bitarchiveitemoffset.hpp"
 #include "bitformat.hpp"
+#include "bitextractionarena.hpp"
 #include "bitfs.hpp"
+#include "bititemcontent.hpp"
+#include "bititemsink.hpp"
+#include "bitprefetcheditems.hpp"
 
 struct IInStream;
 struct IInArchive;
@@ -34,6 +43,33 @@ enum struct ArchiveStartOffset : std::uint8_t {
     FileStart ///< Check only the file start for the archive's start.
 };
 
+/**
+ * @brief An entry of the listing of a directory inside an archive (see BitInputArchive::listDirectory).
+ */
+struct BitDirectoryEntry {
+    tstring name;   ///< The name of the entry.
+    uint32_t index; ///< The index of the item having the entry's path, or kNoItem if there's no such item
+                    ///< (e.g., a directory only implied by the paths of the items inside it).
+    bool isDir;     ///< Whether the entry is a directory.
+
+    static constexpr auto kNoItem = std::numeric_limits< uint32_t >::max();
+};
+
+/**
+ * @brief An item whose extraction failed (see ErrorPolicy::Continue).
+ */
+struct BitItemError {
+    uint32_t index;        ///< The index of the failed item.
+    tstring path;          ///< The path of the failed item in the archive.
+    std::error_code error; ///< The error that made the item fail.
+};
+
+class ArchiveTreeIndex;
+
+class BitItemStream;
+
+class FileExtractCallback;
+
 /**
  * @brief The BitInputArchive class, given a handler object, allows reading/extracting the content of archives.
  */
@@ -91,6 +127,29 @@ class BitInputArchive {
                          std::istream& inStream,
                          ArchiveStartOffset startOffset = ArchiveStartOffset::None );
 
+        /**
+         * @brief Constructs a BitInputArchive object, opening the archive stored as an item of another archive,
+         *        without extracting it first.
+         *
+         * If the format of the parent archive provides a seekable stream for the item (e.g., for the files stored
+         * without compression in tar archives), the nested archive is read directly from it. Otherwise, the item
+         * is decoded into a buffer or, if it is too large, into a temporary file (see BitItemStream).
+         *
+         * @note The parent archive must outlive the nested one, which is not a file on the filesystem
+         *       (i.e., its archivePath() is the empty string).
+         *
+         * @param handler       the reference to the BitAbstractArchiveHandler object containing all the settings to
+         *                      be used for reading the input archive
+         * @param parentArchive the archive containing the nested archive.
+         * @param index         the index of the nested archive's item in the parent archive.
+         * @param startOffset   (optional) whether to search for the archive's start throughout the entire file
+         *                      or only at the beginning. The default behavior is to search at the beginning.
+         */
+        BitInputArchive( const BitAbstractArchiveHandler& handler,
+                         const BitInputArchive& parentArchive,
+                         uint32_t index,
+                         ArchiveStartOffset startOffset = ArchiveStartOffset::None );
+
         BitInputArchive( const BitInputArchive& ) = delete;
 
         BitInputArchive( BitInputArchive&& ) = delete;
@@ -196,6 +255,19 @@ class BitInputArchive {
          */
         void extractTo( const tstring& outDir, const std::vector< uint32_t >& indices ) const;
 
+        /**
+         * @brief Extracts the specified items to the chosen directory, skipping the items that fail
+         *        (regardless of the handler's ErrorPolicy) rather than throwing their errors.
+         *
+         * @param outDir      the output directory where the extracted files will be put.
+         * @param indices     the array of indices of the files in the archive that must be extracted
+         *                    (if empty, all the items are extracted).
+         * @param itemErrors  the vector where the errors of the failed items will be appended.
+         */
+        void extractTo( const tstring& outDir,
+                        const std::vector< uint32_t >& indices,
+                        std::vector< BitItemError >& itemErrors ) const;
+
         BIT7Z_DEPRECATED_MSG("Since v4.0; please, use the extractTo method.")
         inline void extract( std::vector< byte_t >& outBuffer, uint32_t index = 0 ) const {
             extractTo( outBuffer, index );
@@ -275,6 +347,70 @@ class BitInputArchive {
          */
         void extractTo( std::ostream& outStream, uint32_t index = 0 ) const;
 
+        /**
+         * @brief Extracts the specified items to the given buffers, decoding the archive only once.
+         *
+         * @note The paths of the items can be converted to their indices using the find method.
+         *
+         * @param outBuffers the output buffers: the i-th buffer will contain the content of the i-th given item.
+         * @param indices    the indices of the files in the archive that must be extracted.
+         */
+        void extractTo( std::vector< std::vector< byte_t > >& outBuffers, const std::vector< uint32_t >& indices ) const;
+
+        /**
+         * @brief Extracts at most the first prefixSize bytes of each of the specified items to the given buffers,
+         *        stopping the decoding of each item as soon as its prefix is complete, where the format allows it.
+         *
+         * In non-solid archives, the rest of an item is never decoded; in solid archives, the following items
+         * depend on it, so it is decoded and discarded, but the extraction stops after the last requested prefix.
+         *
+         * @note The integrity of an item (e.g., its CRC) is not checked if its decoding is stopped.
+         *
+         * @param outBuffers the output buffers: the i-th buffer will contain the prefix of the i-th given item.
+         * @param prefixSize the maximum number of bytes to be extracted from each item.
+         * @param indices    the indices of the files in the archive whose prefixes must be extracted.
+         */
+        void extractPrefixes( std::vector< std::vector< byte_t > >& outBuffers,
+                              std::size_t prefixSize,
+                              const std::vector< uint32_t >& indices ) const;
+
+        /**
+         * @brief Extracts the specified files (or all the files, if no index is given) to the given arena,
+         *        i.e., to a single buffer allocated only once with the total size of the files.
+         *
+         * @param outArena the output arena (its previous content is discarded).
+         * @param indices  the indices of the items in the archive that must be extracted (folders are ignored).
+         */
+        void extractTo( BitExtractionArena& outArena, const std::vector< uint32_t >& indices = {} ) const;
+
+        /**
+         * @brief Extracts the specified files (or all the files, if no index is given) in a single pass,
+         *        streaming the content of each file to the sink created for it by the given factory.
+         *
+         * @note The factory is called once for each file (folders are ignored), in the order the files are decoded;
+         *       only the content of a single file is kept alive at a time.
+         *
+         * @param sinkFactory the function creating the sink of each file (or a null sink, for skipping the file).
+         * @param indices     the indices of the items in the archive that must be extracted.
+         */
+        void extractTo( const ItemSinkFactory& sinkFactory, const std::vector< uint32_t >& indices = {} ) const;
+
+        /**
+         * @brief Extracts only the given byte range of the specified file to the given sink.
+         *
+         * If the archive format provides a seekable stream for the file (e.g., for the files stored without
+         * compression in tar or iso archives), the range is read directly; otherwise, the file is decoded
+         * up to the end of the range, and then its decoding is stopped.
+         *
+         * @note The integrity of the file (e.g., its CRC) is not checked if its decoding is stopped.
+         *
+         * @param index  the index of the file to be extracted.
+         * @param offset the offset of the range from the start of the file's content.
+         * @param length the length of the range (it is shorter if the file ends before its end).
+         * @param sink   the sink receiving the content of the range.
+         */
+        void extractRange( uint32_t index, uint64_t offset, uint64_t length, BitItemSink& sink ) const;
+
         BIT7Z_DEPRECATED_MSG("Since v4.0; please, use the extractTo method.")
         inline void extract( std::map< tstring, std::vector< byte_t > >& outMap ) const {
             extractTo( outMap );
@@ -288,6 +424,24 @@ class BitInputArchive {
          */
         void extractTo( std::map< tstring, std::vector< byte_t > >& outMap ) const;
 
+        /**
+         * @brief Extracts the content of the archive to a map of item contents, where the keys are the paths
+         * of the files (inside the archive), keeping in memory only the contents within the given limits.
+         *
+         * A file is moved to an anonymous temporary file as soon as its decoded content exceeds the item memory
+         * threshold, or the memory used by all the contents would exceed the memory budget; the limits are checked
+         * against the decoded data, so they hold even if the sizes declared by the archive are wrong.
+         *
+         * @param outMap              the output map.
+         * @param itemMemoryThreshold the maximum size of a file kept in memory.
+         * @param memoryBudget        the maximum memory used by all the files kept in memory.
+         * @param spillDirectory      the directory of the temporary files (if empty, the system's temporary directory).
+         */
+        void extractTo( std::map< tstring, BitItemContent >& outMap,
+                        uint64_t itemMemoryThreshold,
+                        uint64_t memoryBudget = std::numeric_limits< uint64_t >::max(),
+                        const tstring& spillDirectory = {} ) const;
+
         /**
          * @brief Tests the archive without extracting its content.
          *
@@ -309,18 +463,54 @@ class BitInputArchive {
 
         BIT7Z_NODISCARD auto close() const noexcept -> HRESULT;
 
+        /**
+         * @return a new reference to the seekable stream of the content of the given item,
+         *         or nullptr if the archive handler doesn't provide it (e.g., for compressed items).
+         */
+        BIT7Z_NODISCARD auto openItemStream( uint32_t index ) const -> IInStream*;
+
+        /**
+         * @return the path used for naming the items without a path: the path to the archive or, for nested
+         *         archives, the path of their item in the parent archive (the empty string for buffer/stream archives).
+         */
+        BIT7Z_NODISCARD auto archiveName() const noexcept -> const tstring&;
+
         friend class BitAbstractArchiveOpener;
 
         friend class BitAbstractArchiveCreator;
 
         friend class BitOutputArchive;
 
+        friend class BitArchiveEditor;
+
+        friend class BitItemStream;
+
+        friend class FileExtractCallback;
+
+        BIT7Z_NODISCARD auto treeIndex() const -> const ArchiveTreeIndex&;
+
     private:
         IInArchive* mInArchive;
         const BitInFormat* mDetectedFormat;
         const BitAbstractArchiveHandler& mArchiveHandler;
         tstring mArchivePath;
 
+        // Path used only for naming the items without a path (see archiveName()).
+        tstring mArchiveName;
+
+        // Index of the items by (normalized) path, lazily created the first time an item is searched.
+        mutable std::unique_ptr< std::unordered_map< tstring, uint32_t > > mPathIndex;
+        mutable std::mutex mPathIndexMutex;
+
+        BIT7Z_NODISCARD auto pathIndex() const -> const std::unordered_map< tstring, uint32_t >&;
+
+        // Index of the archive's directory tree, lazily created the first time a directory is queried.
+        mutable std::unique_ptr< ArchiveTreeIndex > mTreeIndex;
+        mutable std::mutex mTreeIndexMutex;
+
+        // Content of the item of the parent archive, if this is a nested archive that cannot be read directly.
+        std::unique_ptr< BitItemStream > mNestedStream;
+
         BIT7Z_NODISCARD
         auto openArchiveStream( const fs::path& name, IInStream* inStream, ArchiveStartOffset startOffset ) -> IInArchive*;
 
@@ -417,9 +607,27 @@ class BitInputArchive {
          */
         BIT7Z_NODISCARD auto cend() const noexcept -> BitInputArchive::ConstIterator;
 
+        /**
+         * @brief Creates a range over the archive's items that loads the given properties (columns)
+         *        of a window of items at a time, so that accessing them doesn't require querying the archive.
+         *
+         * @note Useful for scanning all the archive's items, e.g., for filtering them.
+         *
+         * @param columns    the properties to be loaded for each item.
+         * @param windowSize the number of items whose properties are loaded at once.
+         *
+         * @return the range over the archive's items.
+         */
+        BIT7Z_NODISCARD auto prefetchedItems( ItemsTableColumns columns = ItemsTableColumns::All,
+                                              uint32_t windowSize = BitPrefetchedItems::kDefaultWindowSize ) const
+            -> BitPrefetchedItems;
+
         /**
          * @brief Find an item in the archive that has the given path.
          *
+         * @note The first search builds an index of the archive items by path,
+         *       so that the following searches take constant time.
+         *
          * @param path the path to be searched in the archive.
          *
          * @return an iterator to the item with the given path, or an iterator equal to the end() iterator
@@ -445,6 +653,29 @@ class BitInputArchive {
          */
         BIT7Z_NODISCARD auto itemAt( uint32_t index ) const -> BitArchiveItemOffset;
 
+        /**
+         * @brief Lists the entries directly inside the given directory of the archive.
+         *
+         * @note The first listing builds an index of the archive's directory tree,
+         *       so that the following listings take time proportional to the size of their result.
+         *
+         * @param path the path of the directory inside the archive (an empty path is the archive's root).
+         *
+         * @return the entries of the directory (empty if there's no such directory).
+         */
+        BIT7Z_NODISCARD auto listDirectory( const tstring& path ) const -> std::vector< BitDirectoryEntry >;
+
+        /**
+         * @brief Finds all the items inside the given directory of the archive, recursively.
+         *
+         * @note Like listDirectory, it uses the index of the archive's directory tree.
+         *
+         * @param path the path of the directory inside the archive (an empty path is the archive's root).
+         *
+         * @return the indices of the items inside the directory (excluding the directory itself).
+         */
+        BIT7Z_NODISCARD auto subtree( const tstring& path ) const -> std::vector< uint32_t >;
+
 };
 
 }  // namespace bit7z
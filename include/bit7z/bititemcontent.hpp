@@ -0,0 +1,78 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITITEMCONTENT_HPP
+#define BITITEMCONTENT_HPP
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <streambuf>
+
+#include "bitdefines.hpp"
+#include "bittypes.hpp"
+
+namespace bit7z {
+
+/**
+ * @brief The BitItemContent class holds the extracted content of an item, either in a memory buffer or,
+ *        if it exceeded the memory limits of the extraction, in an anonymous temporary file.
+ *
+ * The temporary file is deleted when the content is destroyed.
+ */
+class BitItemContent final {
+    public:
+        BitItemContent();
+
+        BitItemContent( const BitItemContent& ) = delete;
+
+        BitItemContent( BitItemContent&& ) noexcept;
+
+        auto operator=( const BitItemContent& ) -> BitItemContent& = delete;
+
+        auto operator=( BitItemContent&& ) noexcept -> BitItemContent&;
+
+        ~BitItemContent();
+
+        /**
+         * @return true if the content is held in memory, false if it was spilled to a temporary file.
+         */
+        BIT7Z_NODISCARD auto isInMemory() const noexcept -> bool;
+
+        /**
+         * @return the size of the content.
+         */
+        BIT7Z_NODISCARD auto size() const noexcept -> uint64_t;
+
+        /**
+         * @return the buffer holding the content (empty if the content was spilled to a temporary file).
+         */
+        BIT7Z_NODISCARD auto buffer() const noexcept -> const buffer_t&;
+
+        /**
+         * @return a seekable (binary) input stream over the content, positioned at its start.
+         *
+         * @note The stream is owned by this object: each call returns the same stream, rewound.
+         */
+        auto stream() -> std::istream&;
+
+    private:
+        buffer_t mBuffer;
+        std::unique_ptr< std::streambuf > mSpillFile;
+        uint64_t mSize;
+
+        std::unique_ptr< std::streambuf > mBufferStreamBuf;
+        std::unique_ptr< std::istream > mStream;
+
+        friend class CSpillOutStream;
+};
+
+}  // namespace bit7z
+
+#endif // BITITEMCONTENT_HPP
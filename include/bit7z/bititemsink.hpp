@@ -0,0 +1,64 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITITEMSINK_HPP
+#define BITITEMSINK_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "bitarchiveitemoffset.hpp"
+#include "bittypes.hpp"
+
+namespace bit7z {
+
+/**
+ * @brief The BitItemSink class is the interface of the objects receiving the content of an extracted item.
+ */
+class BitItemSink {
+    public:
+        BitItemSink() = default;
+
+        BitItemSink( const BitItemSink& ) = default;
+
+        BitItemSink( BitItemSink&& ) = default;
+
+        auto operator=( const BitItemSink& ) -> BitItemSink& = default;
+
+        auto operator=( BitItemSink&& ) -> BitItemSink& = default;
+
+        virtual ~BitItemSink() = default;
+
+        /**
+         * @brief Receives the next chunk of the decoded content of the item.
+         *
+         * @param data the pointer to the chunk (valid only during the call).
+         * @param size the size of the chunk.
+         *
+         * @return false if the extraction must be aborted, true otherwise.
+         */
+        virtual auto write( const byte_t* data, std::size_t size ) -> bool = 0;
+
+        /**
+         * @brief Called after all the content of the item has been received and checked.
+         */
+        virtual void finish() {}
+};
+
+/**
+ * @brief A function creating the sink for an item to be extracted, given the item's metadata.
+ *
+ * Returning a null sink skips the item: if the archive format allows it, the item is not even decoded.
+ */
+using ItemSinkFactory = std::function< std::unique_ptr< BitItemSink >( const BitArchiveItemOffset& ) >;
+
+}  // namespace bit7z
+
+#endif // BITITEMSINK_HPP
@@ -0,0 +1,81 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITITEMSTREAM_HPP
+#define BITITEMSTREAM_HPP
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <streambuf>
+
+#include "bitdefines.hpp"
+#include "bitinputarchive.hpp"
+#include "bittypes.hpp"
+
+namespace bit7z {
+
+/**
+ * @brief The BitItemStream class is a seekable (binary) input stream over the content of a file in an archive.
+ *
+ * If the archive format provides a seekable stream for the file (e.g., for the files stored without compression
+ * in tar or iso archives), the content is read directly from the archive, on demand. Otherwise, the file is
+ * decoded once, when the stream is created, into a memory buffer or, if it is larger than the given
+ * maximum memory size, into a temporary file (deleted when the stream is destroyed).
+ *
+ * @note The input archive must outlive the stream, and it must not be used by other threads while the stream
+ *       is being read.
+ */
+class BitItemStream final : public std::istream {
+    public:
+        static constexpr auto kDefaultMaxMemorySize = static_cast< uint64_t >( 64 * 1024 * 1024 );
+
+        /**
+         * @brief Constructs a stream over the content of the given file in the archive.
+         *
+         * @param inputArchive   the archive containing the file.
+         * @param index          the index of the file in the archive.
+         * @param maxMemorySize  the maximum size of a file decoded in memory (larger files are decoded to disk).
+         * @param spillDirectory the directory of the temporary files (if empty, the system's temporary directory).
+         */
+        BitItemStream( const BitInputArchive& inputArchive,
+                       uint32_t index,
+                       uint64_t maxMemorySize = kDefaultMaxMemorySize,
+                       const tstring& spillDirectory = {} );
+
+        BitItemStream( const BitItemStream& ) = delete;
+
+        BitItemStream( BitItemStream&& ) = delete;
+
+        auto operator=( const BitItemStream& ) -> BitItemStream& = delete;
+
+        auto operator=( BitItemStream&& ) -> BitItemStream& = delete;
+
+        ~BitItemStream() override;
+
+        /**
+         * @return the size of the content of the file.
+         */
+        BIT7Z_NODISCARD auto size() const noexcept -> uint64_t;
+
+        /**
+         * @return true if the content is read directly from the archive, false if the file was decoded.
+         */
+        BIT7Z_NODISCARD auto isDirect() const noexcept -> bool;
+
+    private:
+        buffer_t mItemContent; // The decoded content of the file, if it is kept in memory.
+        std::unique_ptr< std::streambuf > mItemBuffer;
+        uint64_t mSize;
+        bool mIsDirect;
+};
+
+}  // namespace bit7z
+
+#endif // BITITEMSTREAM_HPP
@@ -0,0 +1,229 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITPREFETCHEDITEMS_HPP
+#define BITPREFETCHEDITEMS_HPP
+
+#include <cstdint>
+#include <iterator>
+
+#include "bitarchiveitemstable.hpp"
+#include "bitdefines.hpp"
+#include "bittypes.hpp"
+
+namespace bit7z {
+
+class BitInputArchive;
+class BitPrefetchedItems;
+
+/**
+ * @brief The BitPrefetchedItem class is a view on an archived item whose properties
+ *        were prefetched by a BitPrefetchedItems range.
+ *
+ * @note Only the properties of the columns requested to the range are available;
+ *       the other accessors return the same default values as BitArchiveItemsTable.
+ */
+class BitPrefetchedItem final {
+    public:
+        /**
+         * @return the index of the item in the archive.
+         */
+        BIT7Z_NODISCARD auto index() const noexcept -> uint32_t;
+
+        /**
+         * @return true if and only if the item is a directory.
+         */
+        BIT7Z_NODISCARD auto isDir() const -> bool;
+
+        /**
+         * @return the path of the item.
+         */
+        BIT7Z_NODISCARD auto path() const -> tstring;
+
+        /**
+         * @return a pointer to the (not null-terminated) path of the item in the range's buffer;
+         *         it is valid until the range loads another window of items.
+         */
+        BIT7Z_NODISCARD auto pathData() const -> const tchar*;
+
+        /**
+         * @return the length of the path of the item.
+         */
+        BIT7Z_NODISCARD auto pathLength() const -> std::size_t;
+
+        /**
+         * @return the uncompressed size of the item.
+         */
+        BIT7Z_NODISCARD auto size() const -> uint64_t;
+
+        /**
+         * @return the compressed size of the item.
+         */
+        BIT7Z_NODISCARD auto packSize() const -> uint64_t;
+
+        /**
+         * @return true if and only if the last write time of the item is available.
+         */
+        BIT7Z_NODISCARD auto hasLastWriteTime() const -> bool;
+
+        /**
+         * @return the last write time of the item.
+         */
+        BIT7Z_NODISCARD auto lastWriteTime() const -> time_type;
+
+        /**
+         * @return true if and only if the CRC of the item is available.
+         */
+        BIT7Z_NODISCARD auto hasCrc() const -> bool;
+
+        /**
+         * @return the CRC of the item (zero if not available).
+         */
+        BIT7Z_NODISCARD auto crc() const -> uint32_t;
+
+        /**
+         * @return the attributes of the item.
+         */
+        BIT7Z_NODISCARD auto attributes() const -> uint32_t;
+
+        /**
+         * @return true if and only if the item is encrypted.
+         */
+        BIT7Z_NODISCARD auto isEncrypted() const -> bool;
+
+    private:
+        const BitPrefetchedItems* mItems;
+        uint32_t mIndex;
+
+        BitPrefetchedItem( const BitPrefetchedItems& items, uint32_t index ) noexcept;
+
+        BIT7Z_NODISCARD auto window() const -> const BitArchiveItemsTable&;
+
+        BIT7Z_NODISCARD auto row() const -> uint32_t;
+
+        friend class BitPrefetchedItems;
+};
+
+/**
+ * @brief The BitPrefetchedItems class is a range over the items of an archive that reads their properties
+ *        a window of items at a time into a reusable columnar buffer.
+ *
+ * Accessing the properties of the items through the range costs a plain read from the buffer,
+ * instead of querying the archive (and converting the property value) each time.
+ *
+ * @note The window is loaded lazily, only when the properties of one of its items are accessed.
+ */
+class BitPrefetchedItems final {
+    public:
+        /**
+         * @brief The default number of items whose properties are loaded at once.
+         */
+        static constexpr uint32_t kDefaultWindowSize = 256;
+
+        /**
+         * @brief An iterator for the items of a BitPrefetchedItems range.
+         */
+        class ConstIterator {
+            public:
+                // iterator traits
+                using iterator_category BIT7Z_MAYBE_UNUSED = std::input_iterator_tag;
+                using value_type BIT7Z_MAYBE_UNUSED = BitPrefetchedItem;
+                using reference = const BitPrefetchedItem&;
+                using pointer = const BitPrefetchedItem*;
+                using difference_type BIT7Z_MAYBE_UNUSED = uint32_t;
+
+                /**
+                 * @brief Advances the iterator to the next item.
+                 *
+                 * @return the iterator pointing to the next item.
+                 */
+                auto operator++() noexcept -> ConstIterator&;
+
+                /**
+                 * @brief Advances the iterator to the next item.
+                 *
+                 * @return the iterator before the advancement.
+                 */
+                auto operator++( int ) noexcept -> ConstIterator; // NOLINT(cert-dcl21-cpp)
+
+                /**
+                 * @param other Another iterator.
+                 *
+                 * @return whether the two iterators point to the same item or not.
+                 */
+                auto operator==( const ConstIterator& other ) const noexcept -> bool;
+
+                /**
+                 * @param other Another iterator.
+                 *
+                 * @return whether the two iterators point to different items or not.
+                 */
+                auto operator!=( const ConstIterator& other ) const noexcept -> bool;
+
+                /**
+                 * @return a reference to the pointed-to item.
+                 */
+                auto operator*() const noexcept -> reference;
+
+                /**
+                 * @return a pointer to the pointed-to item.
+                 */
+                auto operator->() const noexcept -> pointer;
+
+            private:
+                BitPrefetchedItem mItem;
+
+                ConstIterator( const BitPrefetchedItems& items, uint32_t index ) noexcept;
+
+                friend class BitPrefetchedItems;
+        };
+
+        /**
+         * @return an iterator to the first item of the archive.
+         */
+        BIT7Z_NODISCARD auto begin() const noexcept -> ConstIterator;
+
+        /**
+         * @return an iterator to the item following the last item of the archive.
+         */
+        BIT7Z_NODISCARD auto end() const noexcept -> ConstIterator;
+
+        /**
+         * @return the columns loaded for each item.
+         */
+        BIT7Z_NODISCARD auto columns() const noexcept -> ItemsTableColumns;
+
+        /**
+         * @return the number of items whose properties are loaded at once.
+         */
+        BIT7Z_NODISCARD auto windowSize() const noexcept -> uint32_t;
+
+    private:
+        const BitInputArchive* mArchive;
+        uint32_t mItemsCount;
+        uint32_t mWindowSize;
+
+        // The properties of the items in [mWindowStart, mWindowStart + mWindow.itemsCount()).
+        mutable BitArchiveItemsTable mWindow;
+        mutable uint32_t mWindowStart;
+
+        /* BitPrefetchedItems objects can be created only by BitInputArchive */
+        BitPrefetchedItems( const BitInputArchive& archive, ItemsTableColumns columns, uint32_t windowSize );
+
+        // Returns the row of the given item in the window, loading the window starting from the item if needed.
+        BIT7Z_NODISCARD auto windowRow( uint32_t index ) const -> uint32_t;
+
+        friend class BitInputArchive;
+
+        friend class BitPrefetchedItem;
+};
+
+}  // namespace bit7z
+
+#endif // BITPREFETCHEDITEMS_HPP
@@ -14,13 +14,20 @@
 
 using namespace bit7z;
 
+constexpr auto kDefaultWriterMemoryLimit = 64ull * 1024ull * 1024ull; // 64 MiB
+
 BitAbstractArchiveHandler::BitAbstractArchiveHandler( const Bit7zLibrary& lib,
                                                       tstring password,
                                                       OverwriteMode overwriteMode )
     : mLibrary{ lib },
       mPassword{ std::move( password ) },
       mRetainDirectories{ true },
-      mOverwriteMode{ overwriteMode } {}
+      mOverwriteMode{ overwriteMode },
+      mWriterThreads{ 0 },
+      mWriterMemoryLimit{ kDefaultWriterMemoryLimit },
+      mSparseExtraction{ false },
+      mMemoryMappedThreshold{ 0 },
+      mErrorPolicy{ ErrorPolicy::Abort } {}
 
 auto BitAbstractArchiveHandler::library() const noexcept -> const Bit7zLibrary& {
     return mLibrary;
@@ -62,6 +69,30 @@ auto BitAbstractArchiveHandler::overwriteMode() const -> OverwriteMode {
     return mOverwriteMode;
 }
 
+auto BitAbstractArchiveHandler::writerThreads() const noexcept -> uint32_t {
+    return mWriterThreads;
+}
+
+auto BitAbstractArchiveHandler::writerMemoryLimit() const noexcept -> uint64_t {
+    return mWriterMemoryLimit;
+}
+
+auto BitAbstractArchiveHandler::sparseExtraction() const noexcept -> bool {
+    return mSparseExtraction;
+}
+
+auto BitAbstractArchiveHandler::memoryMappedThreshold() const noexcept -> uint64_t {
+    return mMemoryMappedThreshold;
+}
+
+auto BitAbstractArchiveHandler::errorPolicy() const noexcept -> ErrorPolicy {
+    return mErrorPolicy;
+}
+
+auto BitAbstractArchiveHandler::extractionJournal() const -> tstring {
+    return mExtractionJournal;
+}
+
 void BitAbstractArchiveHandler::setPassword( const tstring& password ) {
     mPassword = password;
 }
@@ -97,3 +128,27 @@ void BitAbstractArchiveHandler::setPasswordCallback( const PasswordCallback& cal
 void BitAbstractArchiveHandler::setOverwriteMode( OverwriteMode mode ) {
     mOverwriteMode = mode;
 }
+
+void BitAbstractArchiveHandler::setWriterThreads( uint32_t threadsCount ) noexcept {
+    mWriterThreads = threadsCount;
+}
+
+void BitAbstractArchiveHandler::setWriterMemoryLimit( uint64_t memoryLimit ) noexcept {
+    mWriterMemoryLimit = memoryLimit;
+}
+
+void BitAbstractArchiveHandler::setSparseExtraction( bool sparse ) noexcept {
+    mSparseExtraction = sparse;
+}
+
+void BitAbstractArchiveHandler::setMemoryMappedThreshold( uint64_t threshold ) noexcept {
+    mMemoryMappedThreshold = threshold;
+}
+
+void BitAbstractArchiveHandler::setErrorPolicy( ErrorPolicy policy ) noexcept {
+    mErrorPolicy = policy;
+}
+
+void BitAbstractArchiveHandler::setExtractionJournal( const tstring& journalPath ) {
+    mExtractionJournal = journalPath;
+}
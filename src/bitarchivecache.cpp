@@ -0,0 +1,273 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "bitarchivecache.hpp"
+#include "bitexception.hpp"
+#include "internal/fs.hpp"
+#include "internal/stringutil.hpp"
+
+namespace bit7z {
+
+// The idle readers of an archive in the cache.
+class BitArchiveReaderPool final {
+    public:
+        explicit BitArchiveReaderPool( uint64_t readerMemoryUsage )
+            : mReaderMemoryUsage{ readerMemoryUsage }, mIsEvicted{ false } {}
+
+        // Returns one of the idle readers, or nullptr if all the readers of the archive are leased.
+        auto acquire() -> std::unique_ptr< BitArchiveReader > {
+            const std::lock_guard< std::mutex > lock{ mMutex };
+            if ( mIdleReaders.empty() ) {
+                return nullptr;
+            }
+            auto reader = std::move( mIdleReaders.back() );
+            mIdleReaders.pop_back();
+            return reader;
+        }
+
+        // Gives back the reader of an ended lease, closing it if the archive has been evicted from the cache.
+        void giveBack( std::unique_ptr< BitArchiveReader > reader ) noexcept {
+            const std::lock_guard< std::mutex > lock{ mMutex };
+            if ( mIsEvicted ) {
+                return;
+            }
+            try {
+                mIdleReaders.push_back( std::move( reader ) );
+            } catch ( const std::bad_alloc& ) { // The reader cannot be kept, so it is closed.
+            }
+        }
+
+        void evict() noexcept {
+            const std::lock_guard< std::mutex > lock{ mMutex };
+            mIsEvicted = true;
+            mIdleReaders.clear();
+        }
+
+        auto memoryUsage() const -> uint64_t {
+            const std::lock_guard< std::mutex > lock{ mMutex };
+            return mReaderMemoryUsage * mIdleReaders.size();
+        }
+
+    private:
+        const uint64_t mReaderMemoryUsage;
+        mutable std::mutex mMutex;
+        std::vector< std::unique_ptr< BitArchiveReader > > mIdleReaders;
+        bool mIsEvicted;
+};
+
+BitArchiveLease::BitArchiveLease( std::shared_ptr< BitArchiveReaderPool > pool,
+                                  std::unique_ptr< BitArchiveReader > reader )
+    : mPool{ std::move( pool ) }, mReader{ std::move( reader ) } {}
+
+BitArchiveLease::BitArchiveLease( BitArchiveLease&& other ) noexcept
+    : mPool{ std::move( other.mPool ) }, mReader{ std::move( other.mReader ) } {}
+
+auto BitArchiveLease::operator=( BitArchiveLease&& other ) noexcept -> BitArchiveLease& {
+    if ( this != &other ) {
+        release();
+        mPool = std::move( other.mPool );
+        mReader = std::move( other.mReader );
+    }
+    return *this;
+}
+
+BitArchiveLease::~BitArchiveLease() {
+    release();
+}
+
+void BitArchiveLease::release() noexcept {
+    if ( mPool != nullptr && mReader != nullptr ) {
+        mPool->giveBack( std::move( mReader ) );
+    }
+    mReader.reset();
+    mPool.reset();
+}
+
+auto BitArchiveLease::reader() const noexcept -> const BitArchiveReader& {
+    return *mReader;
+}
+
+auto BitArchiveLease::operator*() const noexcept -> const BitArchiveReader& {
+    return *mReader;
+}
+
+auto BitArchiveLease::operator->() const noexcept -> const BitArchiveReader* {
+    return mReader.get();
+}
+
+} // namespace bit7z
+
+using namespace bit7z;
+
+namespace {
+// Rough estimate of the memory needed by 7-Zip (and bit7z) for the metadata of each item of an opened archive.
+constexpr uint64_t kItemMemoryEstimate = 512;
+
+// Rough estimate of the memory needed by an opened archive, regardless of its items.
+constexpr uint64_t kArchiveMemoryEstimate = 64ull * 1024ull;
+
+inline void hash_combine( std::size_t& seed, std::size_t value ) noexcept {
+    constexpr std::size_t kGoldenRatio = 0x9e3779b9;
+    seed ^= value + kGoldenRatio + ( seed << 6u ) + ( seed >> 2u );
+}
+
+// Returns the canonical form of the given path, so that different paths to the same file share the same key.
+auto canonical_path( const fs::path& path ) -> fs::path {
+    std::error_code error;
+    auto result = fs::weakly_canonical( path, error );
+    return error ? path.lexically_normal() : result;
+}
+} // namespace
+
+auto BitArchiveCache::ArchiveKey::operator==( const ArchiveKey& other ) const noexcept -> bool {
+    return size == other.size && modifiedTime == other.modifiedTime && format == other.format &&
+           passwordHash == other.passwordHash && path == other.path;
+}
+
+auto BitArchiveCache::ArchiveKeyHash::operator()( const ArchiveKey& key ) const noexcept -> std::size_t {
+    std::size_t result = std::hash< tstring >{}( key.path );
+    hash_combine( result, std::hash< uint64_t >{}( key.size ) );
+    hash_combine( result, std::hash< int64_t >{}( key.modifiedTime ) );
+    hash_combine( result, key.format );
+    hash_combine( result, key.passwordHash );
+    return result;
+}
+
+BitArchiveCache::BitArchiveCache( const Bit7zLibrary& lib, std::size_t maxArchives, uint64_t memoryBudget )
+    : mLibrary{ lib },
+      mMaxArchives{ maxArchives },
+      mMemoryBudget{ memoryBudget },
+      mHits{ 0 },
+      mMisses{ 0 } {}
+
+auto BitArchiveCache::lease( const tstring& inArchive,
+                             const BitInFormat& format,
+                             const tstring& password ) -> BitArchiveLease {
+    const fs::path archivePath = canonical_path( tstring_to_path( inArchive ) );
+
+    std::error_code error;
+    const auto fileSize = fs::file_size( archivePath, error );
+    if ( error ) {
+        throw BitException( "Failed to open the archive", error, inArchive );
+    }
+    const auto modifiedTime = fs::last_write_time( archivePath, error );
+    if ( error ) {
+        throw BitException( "Failed to open the archive", error, inArchive );
+    }
+
+    ArchiveKey key{ path_to_tstring( archivePath ),
+                    fileSize,
+                    static_cast< int64_t >( modifiedTime.time_since_epoch().count() ),
+                    format.value(),
+                    std::hash< tstring >{}( password ) };
+
+    std::shared_ptr< BitArchiveReaderPool > readers;
+    {
+        const std::lock_guard< std::mutex > lock{ mMutex };
+        const auto cachedArchive = mArchivesIndex.find( key );
+        if ( cachedArchive != mArchivesIndex.end() ) {
+            mArchives.splice( mArchives.begin(), mArchives, cachedArchive->second );
+            readers = cachedArchive->second->readers;
+            evict(); // The readers given back by the ended leases might exceed the memory budget.
+            auto reader = readers->acquire();
+            if ( reader != nullptr ) {
+                ++mHits;
+                return BitArchiveLease{ std::move( readers ), std::move( reader ) };
+            }
+        }
+        ++mMisses;
+    }
+
+    // Opening the archive without holding the lock, so that other threads can lease other archives meanwhile.
+    auto reader = std::make_unique< BitArchiveReader >( mLibrary, key.path, format, password );
+    if ( readers != nullptr ) {
+        return BitArchiveLease{ std::move( readers ), std::move( reader ) };
+    }
+
+    const uint64_t memoryUsage = kArchiveMemoryEstimate + ( kItemMemoryEstimate * reader->itemsCount() );
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    const auto cachedArchive = mArchivesIndex.find( key );
+    if ( cachedArchive != mArchivesIndex.end() ) { // Another thread opened the same archive meanwhile.
+        mArchives.splice( mArchives.begin(), mArchives, cachedArchive->second );
+        readers = cachedArchive->second->readers;
+    } else {
+        readers = std::make_shared< BitArchiveReaderPool >( memoryUsage );
+        mArchives.push_front( CachedArchive{ std::move( key ), readers } );
+        mArchivesIndex.emplace( mArchives.front().key, mArchives.begin() );
+    }
+    evict();
+    return BitArchiveLease{ std::move( readers ), std::move( reader ) };
+}
+
+auto BitArchiveCache::currentMemoryUsage() const -> uint64_t {
+    uint64_t result = 0;
+    for ( const auto& cachedArchive : mArchives ) {
+        result += cachedArchive.readers->memoryUsage();
+    }
+    return result;
+}
+
+void BitArchiveCache::evict() {
+    // Note: the most recently used archive is never evicted, even if it alone exceeds the memory budget.
+    while ( !mArchives.empty() &&
+            ( mArchives.size() > mMaxArchives || ( mArchives.size() > 1 && currentMemoryUsage() > mMemoryBudget ) ) ) {
+        const auto& leastRecentlyUsed = mArchives.back();
+        leastRecentlyUsed.readers->evict();
+        mArchivesIndex.erase( leastRecentlyUsed.key );
+        mArchives.pop_back();
+    }
+}
+
+void BitArchiveCache::clear() {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    for ( const auto& cachedArchive : mArchives ) {
+        cachedArchive.readers->evict();
+    }
+    mArchivesIndex.clear();
+    mArchives.clear();
+}
+
+auto BitArchiveCache::size() const -> std::size_t {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    return mArchives.size();
+}
+
+auto BitArchiveCache::memoryUsage() const -> uint64_t {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    return currentMemoryUsage();
+}
+auto BitArchiveCache::hits() const -> uint64_t {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    return mHits;
+}
+
+auto BitArchiveCache::misses() const -> uint64_t {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    return mMisses;
+}
+
+void BitArchiveCache::setMaxArchives( std::size_t maxArchives ) {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    mMaxArchives = maxArchives;
+    evict();
+}
+
+void BitArchiveCache::setMemoryBudget( uint64_t memoryBudget ) {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    mMemoryBudget = memoryBudget;
+    evict();
+}
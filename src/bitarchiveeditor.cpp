@@ -14,6 +14,7 @@
 
 #include "biterror.hpp"
 #include "bitexception.hpp"
+#include "internal/archivetreeindex.hpp"
 #include "internal/bufferitem.hpp"
 #include "internal/fsitem.hpp"
 #include "internal/renameditem.hpp"
@@ -103,49 +104,16 @@ void BitArchiveEditor::deleteItem( uint32_t index, DeletePolicy policy ) {
         return;
     }
 
-    const auto deletedPath = deletedItem.nativePath() + fs::path::preferred_separator;
-    if ( deletedPath.size() <= 1 ) { // The original path was empty
+    const auto deletedPath = deletedItem.path();
+    if ( deletedPath.empty() ) {
         return;
     }
 
-    for ( const auto& item: *inputArchive() ) {
-        if ( starts_with( item.nativePath(), deletedPath ) ) {
-            markItemAsDeleted( item.index() );
-        }
+    for ( const auto childIndex : inputArchive()->subtree( deletedPath ) ) {
+        markItemAsDeleted( childIndex );
     }
 }
 
-/**
- * Determines if the given itemPath is within the specified base directory.
- *
- * @param itemPath The path to the item to be checked.
- * @param isDir    A boolean indicating whether the itemPath represents a directory.
- * @param base     The base directory against which the itemPath is checked.
- *
- * @return true if the itemPath is located within the base directory, false otherwise.
- */
-inline auto isInsidePath( const fs::path& itemPath, bool isDir, const fs::path& base ) -> bool {
-    const auto relativePath = itemPath.lexically_relative( base ).native();
-    /* The relative path of the item with respect to the base directory can be:
-     * 1) A single dot component;
-     * 2) A path not starting with a dot-dot component (i.e., the item is inside the base path);
-     * 3) A path starting with a dot-dot component (i.e., the item is outside the base path).
-     *
-     * This function is called after having evaluated itemPath == base to false;
-     * also, 7-Zip reports folder paths without trailing separators.
-     * Hence, the first case can be restricted further to only the case
-     * where the base path has a trailing path separator: this means that if
-     * the relative path is a single dot, the item must be a folder to be considered inside the base path.
-     *
-     * The remaining cases 2 and 3 are checked as follows:
-     *   - Either the relative path doesn't start with two dots (and then the item is inside the base path) or
-     *   - It starts with two dots, but it is not a dot-dot component (e.g., a normal filename starting with two dots).
-     */
-    return ( relativePath != BIT7Z_NATIVE_STRING( "." ) || isDir ) &&
-           ( !starts_with( relativePath, BIT7Z_NATIVE_STRING( ".." ) ) ||
-             ( relativePath.size() > 2 && !isPathSeparator( relativePath[ 2 ] ) ) );
-}
-
 void BitArchiveEditor::deleteItem( const tstring& itemPath, DeletePolicy policy ) {
     // The path to be deleted must be relative to the root of the archive.
     if ( itemPath.empty() || isPathSeparator( itemPath.front() ) ) {
@@ -155,19 +123,24 @@ void BitArchiveEditor::deleteItem( const tstring& itemPath, DeletePolicy policy
 
     bool deleted = false;
 
-    // Normalized form of the path to be deleted inside the archive.
-    const auto deletedPath = tstring_to_path( itemPath ).lexically_normal();
-    for ( const auto& item: *inputArchive() ) {
-        const fs::path path = item.nativePath();
-
-        // The current item is marked as deleted if either:
-        //  - it is lexicographically equivalent to the path to be deleted; or
-        //  - we need to recursively delete directories,
-        //    and the path of the item is (lexicographically) inside the path to be deleted.
-        if ( path == deletedPath ||
-             ( policy == DeletePolicy::RecurseDirs && isInsidePath( path, item.isDir(), deletedPath ) ) ) {
-            markItemAsDeleted( item.index() );
-            deleted = true;
+    const auto& treeIndex = inputArchive()->treeIndex();
+    const auto node = treeIndex.findNode( itemPath );
+    if ( node != ArchiveTreeIndex::kNotFound ) {
+        // A path with a trailing separator matches only folders, and only when recursively deleting directories.
+        const bool isDirectoryPath = isPathSeparator( itemPath.back() );
+        for ( const auto index : treeIndex.nodeItems( node ) ) {
+            if ( !isDirectoryPath ||
+                 ( policy == DeletePolicy::RecurseDirs && inputArchive()->isItemFolder( index ) ) ) {
+                markItemAsDeleted( index );
+                deleted = true;
+            }
+        }
+
+        if ( policy == DeletePolicy::RecurseDirs ) {
+            for ( const auto index : treeIndex.subtreeItems( node ) ) {
+                markItemAsDeleted( index );
+                deleted = true;
+            }
         }
     }
 
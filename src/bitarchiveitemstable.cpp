@@ -0,0 +1,205 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "bitarchiveitemstable.hpp"
+#include "biterror.hpp"
+#include "bitexception.hpp"
+#include "bitinputarchive.hpp"
+
+using namespace bit7z;
+
+BitArchiveItemsTable::BitArchiveItemsTable( ItemsTableColumns columns, uint32_t itemsCount )
+    : mColumns{ columns }, mItemsCount{ 0 } {
+    mIsDir.reserve( itemsCount );
+    if ( ( columns & ItemsTableColumns::Path ) != 0 ) {
+        mPathOffsets.reserve( itemsCount + 1 );
+        mPathOffsets.push_back( 0 );
+    }
+    if ( ( columns & ItemsTableColumns::Size ) != 0 ) {
+        mSizes.reserve( itemsCount );
+    }
+    if ( ( columns & ItemsTableColumns::PackSize ) != 0 ) {
+        mPackSizes.reserve( itemsCount );
+    }
+    if ( ( columns & ItemsTableColumns::ModifiedTime ) != 0 ) {
+        mLastWriteTimes.reserve( itemsCount );
+        mHasLastWriteTime.reserve( itemsCount );
+    }
+    if ( ( columns & ItemsTableColumns::Crc ) != 0 ) {
+        mCrcs.reserve( itemsCount );
+        mHasCrc.reserve( itemsCount );
+    }
+    if ( ( columns & ItemsTableColumns::Attributes ) != 0 ) {
+        mAttributes.reserve( itemsCount );
+    }
+    if ( ( columns & ItemsTableColumns::Encrypted ) != 0 ) {
+        mIsEncrypted.reserve( itemsCount );
+    }
+}
+
+void BitArchiveItemsTable::addItem( const BitInputArchive& archive, uint32_t index ) {
+    // Note: only the properties of the requested columns are read from the archive.
+    const BitPropVariant isDir = archive.itemProperty( index, BitProperty::IsDir );
+    mIsDir.push_back( !isDir.isEmpty() && isDir.getBool() );
+
+    if ( ( mColumns & ItemsTableColumns::Path ) != 0 ) {
+        BitPropVariant path = archive.itemProperty( index, BitProperty::Path );
+        if ( path.isEmpty() ) {
+            path = archive.itemProperty( index, BitProperty::Name );
+        }
+        if ( !path.isEmpty() ) {
+            mPathsArena += path.getString();
+        }
+        mPathOffsets.push_back( mPathsArena.size() );
+    }
+
+    if ( ( mColumns & ItemsTableColumns::Size ) != 0 ) {
+        const BitPropVariant size = archive.itemProperty( index, BitProperty::Size );
+        mSizes.push_back( size.isEmpty() ? 0 : size.getUInt64() );
+    }
+
+    if ( ( mColumns & ItemsTableColumns::PackSize ) != 0 ) {
+        const BitPropVariant packSize = archive.itemProperty( index, BitProperty::PackSize );
+        mPackSizes.push_back( packSize.isEmpty() ? 0 : packSize.getUInt64() );
+    }
+
+    if ( ( mColumns & ItemsTableColumns::ModifiedTime ) != 0 ) {
+        const BitPropVariant writeTime = archive.itemProperty( index, BitProperty::MTime );
+        mHasLastWriteTime.push_back( writeTime.isFileTime() );
+        mLastWriteTimes.push_back( writeTime.isFileTime() ? writeTime.getTimePoint() : time_type{} );
+    }
+
+    if ( ( mColumns & ItemsTableColumns::Crc ) != 0 ) {
+        const BitPropVariant crc = archive.itemProperty( index, BitProperty::CRC );
+        mHasCrc.push_back( crc.isUInt32() );
+        mCrcs.push_back( crc.isUInt32() ? crc.getUInt32() : 0 );
+    }
+
+    if ( ( mColumns & ItemsTableColumns::Attributes ) != 0 ) {
+        const BitPropVariant attrib = archive.itemProperty( index, BitProperty::Attrib );
+        mAttributes.push_back( attrib.isUInt32() ? attrib.getUInt32() : 0 );
+    }
+
+    if ( ( mColumns & ItemsTableColumns::Encrypted ) != 0 ) {
+        const BitPropVariant isEncrypted = archive.itemProperty( index, BitProperty::Encrypted );
+        mIsEncrypted.push_back( isEncrypted.isBool() && isEncrypted.getBool() );
+    }
+
+    ++mItemsCount;
+}
+
+void BitArchiveItemsTable::clear() noexcept {
+    mItemsCount = 0;
+    mPathsArena.clear();
+    if ( !mPathOffsets.empty() ) {
+        mPathOffsets.resize( 1 ); // The offset of the first path.
+    }
+    mSizes.clear();
+    mPackSizes.clear();
+    mLastWriteTimes.clear();
+    mCrcs.clear();
+    mAttributes.clear();
+    mIsDir.clear();
+    mHasLastWriteTime.clear();
+    mHasCrc.clear();
+    mIsEncrypted.clear();
+}
+
+void BitArchiveItemsTable::checkIndex( uint32_t index ) const {
+    if ( index >= mItemsCount ) {
+        throw BitException( "Cannot get the item at the index " + std::to_string( index ),
+                            make_error_code( BitError::InvalidIndex ) );
+    }
+}
+
+auto BitArchiveItemsTable::columns() const noexcept -> ItemsTableColumns {
+    return mColumns;
+}
+
+auto BitArchiveItemsTable::itemsCount() const noexcept -> uint32_t {
+    return mItemsCount;
+}
+
+auto BitArchiveItemsTable::isDir( uint32_t index ) const -> bool {
+    checkIndex( index );
+    return mIsDir[ index ];
+}
+
+auto BitArchiveItemsTable::path( uint32_t index ) const -> tstring {
+    return tstring{ pathData( index ), pathLength( index ) };
+}
+
+auto BitArchiveItemsTable::pathData( uint32_t index ) const -> const tchar* {
+    checkIndex( index );
+    return mPathOffsets.empty() ? mPathsArena.data() : mPathsArena.data() + mPathOffsets[ index ];
+}
+
+auto BitArchiveItemsTable::pathLength( uint32_t index ) const -> std::size_t {
+    checkIndex( index );
+    return mPathOffsets.empty() ? 0 : mPathOffsets[ index + 1 ] - mPathOffsets[ index ];
+}
+
+auto BitArchiveItemsTable::size( uint32_t index ) const -> uint64_t {
+    checkIndex( index );
+    return mSizes.empty() ? 0 : mSizes[ index ];
+}
+
+auto BitArchiveItemsTable::packSize( uint32_t index ) const -> uint64_t {
+    checkIndex( index );
+    return mPackSizes.empty() ? 0 : mPackSizes[ index ];
+}
+
+auto BitArchiveItemsTable::hasLastWriteTime( uint32_t index ) const -> bool {
+    checkIndex( index );
+    return !mHasLastWriteTime.empty() && mHasLastWriteTime[ index ];
+}
+
+auto BitArchiveItemsTable::lastWriteTime( uint32_t index ) const -> time_type {
+    checkIndex( index );
+    return mLastWriteTimes.empty() ? time_type{} : mLastWriteTimes[ index ];
+}
+
+auto BitArchiveItemsTable::hasCrc( uint32_t index ) const -> bool {
+    checkIndex( index );
+    return !mHasCrc.empty() && mHasCrc[ index ];
+}
+
+auto BitArchiveItemsTable::crc( uint32_t index ) const -> uint32_t {
+    checkIndex( index );
+    return mCrcs.empty() ? 0 : mCrcs[ index ];
+}
+
+auto BitArchiveItemsTable::attributes( uint32_t index ) const -> uint32_t {
+    checkIndex( index );
+    return mAttributes.empty() ? 0 : mAttributes[ index ];
+}
+
+auto BitArchiveItemsTable::isEncrypted( uint32_t index ) const -> bool {
+    checkIndex( index );
+    return !mIsEncrypted.empty() && mIsEncrypted[ index ];
+}
+
+auto BitArchiveItemsTable::sizes() const noexcept -> const std::vector< uint64_t >& {
+    return mSizes;
+}
+
+auto BitArchiveItemsTable::packSizes() const noexcept -> const std::vector< uint64_t >& {
+    return mPackSizes;
+}
+
+auto BitArchiveItemsTable::crcs() const noexcept -> const std::vector< uint32_t >& {
+    return mCrcs;
+}
+
+auto BitArchiveItemsTable::attributesColumn() const noexcept -> const std::vector< uint32_t >& {
+    return mAttributes;
+}
@@ -10,9 +10,6 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 
-#include <algorithm>
-#include <numeric>
-
 #include "bitarchivereader.hpp"
 #include "internal/operationresult.hpp"
 #include "internal/stringutil.hpp"
@@ -58,6 +55,13 @@ BitArchiveReader::BitArchiveReader( const Bit7zLibrary& lib,
                                     const tstring& password )
     : BitAbstractArchiveOpener( lib, format, password ), BitInputArchive( *this, inArchive ) {}
 
+BitArchiveReader::BitArchiveReader( const Bit7zLibrary& lib,
+                                    const BitInputArchive& parentArchive,
+                                    uint32_t index,
+                                    const BitInFormat& format,
+                                    const tstring& password )
+    : BitAbstractArchiveOpener( lib, format, password ), BitInputArchive( *this, parentArchive, index ) {}
+
 auto BitArchiveReader::archiveProperties() const -> map< BitProperty, BitPropVariant > {
     map< BitProperty, BitPropVariant > result;
     for ( uint32_t i = kpidNoProperty; i <= kpidCopyLink; ++i ) {
@@ -91,43 +95,76 @@ auto BitArchiveReader::items() const -> std::vector< BitArchiveItemInfo > {
     return result;
 }
 
+auto BitArchiveReader::itemsTable( ItemsTableColumns columns ) const -> BitArchiveItemsTable {
+    const auto count = itemsCount();
+
+    BitArchiveItemsTable result{ columns, count };
+    for ( uint32_t i = 0; i < count; ++i ) {
+        result.addItem( *this, i );
+    }
+    return result;
+}
+
+auto BitArchiveReader::summary() const -> const BitArchiveSummary& {
+    // The summary is computed by the first call, in a single pass over the items; the later calls return it.
+    const std::lock_guard< std::mutex > lock{ mSummaryMutex };
+    if ( mSummary != nullptr ) {
+        return *mSummary;
+    }
+
+    auto result = std::make_unique< BitArchiveSummary >();
+    for ( const auto& item : *this ) {
+        if ( item.isDir() ) {
+            ++result->foldersCount;
+            continue;
+        }
+
+        const auto itemSize = item.size();
+        const auto itemPackSize = item.packSize();
+        ++result->filesCount;
+        result->size += itemSize;
+        result->packSize += itemPackSize;
+        if ( item.isEncrypted() ) {
+            ++result->encryptedFilesCount;
+        }
+
+        const BitPropVariant method = item.itemProperty( BitProperty::Method );
+        for ( auto* stats : { &result->methods[ method.isString() ? method.getString() : tstring{} ],
+                              &result->extensions[ item.extension() ] } ) {
+            ++stats->filesCount;
+            stats->size += itemSize;
+            stats->packSize += itemPackSize;
+        }
+    }
+    mSummary = std::move( result );
+    return *mSummary;
+}
+
 auto BitArchiveReader::foldersCount() const -> uint32_t {
-    return std::count_if( cbegin(), cend(), []( const BitArchiveItem& item ) {
-        return item.isDir();
-    } );
+    return summary().foldersCount;
 }
 
 auto BitArchiveReader::filesCount() const -> uint32_t {
-    return itemsCount() - foldersCount(); // I'm lazy :)
+    return summary().filesCount;
 }
 
 auto BitArchiveReader::size() const -> uint64_t {
-    return std::accumulate( cbegin(), cend(), 0ull, []( uint64_t accumulator, const BitArchiveItem& item ) {
-        return item.isDir() ? accumulator : accumulator + item.size();
-    } );
+    return summary().size;
 }
 
 auto BitArchiveReader::packSize() const -> uint64_t {
-    return std::accumulate( cbegin(), cend(), 0ull, []( uint64_t accumulator, const BitArchiveItem& item ) {
-        return item.isDir() ? accumulator : accumulator + item.packSize();
-    } );
+    return summary().packSize;
 }
 
 auto BitArchiveReader::hasEncryptedItems() const -> bool {
     /* Note: simple encryption (i.e., not including the archive headers) can be detected only reading
      *       the properties of the files in the archive, so we search for any encrypted file inside the archive. */
-    return std::any_of( cbegin(), cend(), []( const BitArchiveItem& item ) {
-        return !item.isDir() && item.isEncrypted();
-    } );
+    return summary().encryptedFilesCount > 0;
 }
 
 auto BitArchiveReader::isEncrypted() const -> bool {
-    if ( filesCount() == 0 ) {
-        return false;
-    }
-    return std::all_of( cbegin(), cend(), []( const BitArchiveItem& item ) {
-        return item.isDir() || item.isEncrypted();
-    } );
+    const auto& archiveSummary = summary();
+    return archiveSummary.filesCount > 0 && archiveSummary.encryptedFilesCount == archiveSummary.filesCount;
 }
 
 auto BitArchiveReader::isMultiVolume() const -> bool {
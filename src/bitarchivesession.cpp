@@ -0,0 +1,113 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "bitarchivesession.hpp"
+
+using namespace bit7z;
+
+/* Gives a thread the exclusive use of one of the session's readers, opening a new one if all of them are busy;
+ * the reader is given back to the session when the lease ends. */
+class BitArchiveSession::ReaderLease final {
+    public:
+        explicit ReaderLease( const BitArchiveSession& session ) : mSession{ session } {
+            {
+                const std::lock_guard< std::mutex > lock{ mSession.mReadersMutex };
+                if ( !mSession.mIdleReaders.empty() ) {
+                    mReader = std::move( mSession.mIdleReaders.back() );
+                    mSession.mIdleReaders.pop_back();
+                    return;
+                }
+            }
+            mReader = mSession.openReader(); // Opening the archive without holding the lock.
+        }
+
+        ReaderLease( const ReaderLease& ) = delete;
+
+        ReaderLease( ReaderLease&& ) = delete;
+
+        auto operator=( const ReaderLease& ) -> ReaderLease& = delete;
+
+        auto operator=( ReaderLease&& ) -> ReaderLease& = delete;
+
+        ~ReaderLease() {
+            const std::lock_guard< std::mutex > lock{ mSession.mReadersMutex };
+            mSession.mIdleReaders.push_back( std::move( mReader ) );
+        }
+
+        auto operator->() const noexcept -> const BitArchiveReader* {
+            return mReader.get();
+        }
+
+    private:
+        const BitArchiveSession& mSession;
+        std::unique_ptr< BitArchiveReader > mReader;
+};
+
+BitArchiveSession::BitArchiveSession( const Bit7zLibrary& lib,
+                                      const tstring& inArchive,
+                                      const BitInFormat& format,
+                                      const tstring& password )
+    : mLibrary{ lib },
+      mArchivePath{ inArchive },
+      mFormat{ format },
+      mPassword{ password },
+      mReadersCount{ 0 } {
+    auto reader = openReader();
+    mItems = std::make_unique< BitArchiveItemsTable >( reader->itemsTable() );
+    mIdleReaders.push_back( std::move( reader ) ); // The first reader can be reused for the extractions.
+}
+
+BitArchiveSession::~BitArchiveSession() = default;
+
+auto BitArchiveSession::openReader() const -> std::unique_ptr< BitArchiveReader > {
+    auto reader = std::make_unique< BitArchiveReader >( mLibrary, mArchivePath, mFormat, mPassword );
+    const std::lock_guard< std::mutex > lock{ mReadersMutex };
+    ++mReadersCount;
+    return reader;
+}
+
+auto BitArchiveSession::archivePath() const noexcept -> const tstring& {
+    return mArchivePath;
+}
+
+auto BitArchiveSession::itemsCount() const noexcept -> uint32_t {
+    return mItems->itemsCount();
+}
+
+auto BitArchiveSession::items() const noexcept -> const BitArchiveItemsTable& {
+    return *mItems;
+}
+
+auto BitArchiveSession::readersCount() const -> std::size_t {
+    const std::lock_guard< std::mutex > lock{ mReadersMutex };
+    return mReadersCount;
+}
+
+void BitArchiveSession::extractTo( std::vector< byte_t >& outBuffer, uint32_t index ) const {
+    const ReaderLease reader{ *this };
+    reader->extractTo( outBuffer, index );
+}
+
+void BitArchiveSession::extractTo( byte_t* buffer, std::size_t size, uint32_t index ) const {
+    const ReaderLease reader{ *this };
+    reader->extractTo( buffer, size, index );
+}
+
+void BitArchiveSession::extractTo( std::ostream& outStream, uint32_t index ) const {
+    const ReaderLease reader{ *this };
+    reader->extractTo( outStream, index );
+}
+
+void BitArchiveSession::extractTo( const tstring& outDir, const std::vector< uint32_t >& indices ) const {
+    const ReaderLease reader{ *this };
+    reader->extractTo( outDir, indices );
+}
@@ -0,0 +1,219 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "bitentryreader.hpp"
+#include "biterror.hpp"
+#include "bitexception.hpp"
+
+using namespace bit7z;
+
+namespace {
+// Thrown by the worker thread to stop the extraction when the reader is closed.
+struct ReaderClosed final {};
+} // namespace
+
+/* Forwards the decoded content of the current entry to the reader. */
+class BitEntryReader::EntrySink final : public BitItemSink {
+    public:
+        explicit EntrySink( BitEntryReader& reader ) : mReader{ reader } {}
+
+        auto write( const byte_t* data, std::size_t size ) -> bool override {
+            return mReader.writeContent( data, size );
+        }
+
+        void finish() override {
+            mReader.finishEntry();
+        }
+
+    private:
+        BitEntryReader& mReader;
+};
+
+BitEntryReader::BitEntryReader( const BitInputArchive& inputArchive, std::size_t bufferSize )
+    : mInputArchive{ inputArchive },
+      mEntry{},
+      mBuffer( bufferSize ),
+      mBufferHead{ 0 },
+      mBufferUsed{ 0 },
+      mRequestedEntries{ 0 },
+      mStartedEntries{ 0 },
+      mEntryFinished{ false },
+      mExtractionFinished{ false },
+      mClosed{ false } {
+    if ( bufferSize == 0 ) {
+        throw BitException( "Cannot read the archive entries", make_error_code( BitError::InvalidOutputBufferSize ) );
+    }
+}
+
+BitEntryReader::~BitEntryReader() {
+    close();
+}
+
+void BitEntryReader::close() noexcept {
+    {
+        const std::lock_guard< std::mutex > lock{ mMutex };
+        mClosed = true;
+    }
+    mWorkerCondition.notify_all();
+    if ( mWorker.joinable() ) {
+        mWorker.join();
+    }
+}
+
+void BitEntryReader::extractEntries() {
+    std::exception_ptr extractionError;
+    try {
+        mInputArchive.extractTo( [ this ]( const BitArchiveItemOffset& item ) -> std::unique_ptr< BitItemSink > {
+            if ( !startEntry( item ) ) {
+                throw ReaderClosed{};
+            }
+            return std::make_unique< EntrySink >( *this );
+        } );
+    } catch ( const ReaderClosed& ) { // NOLINT(*-empty-catch)
+        // The reader was closed, so nobody is interested in the extraction anymore.
+    } catch ( ... ) {
+        extractionError = std::current_exception();
+    }
+
+    {
+        const std::lock_guard< std::mutex > lock{ mMutex };
+        mExtractionFinished = true;
+        if ( !mClosed ) {
+            mExtractionError = extractionError;
+        }
+    }
+    mReaderCondition.notify_all();
+}
+
+auto BitEntryReader::startEntry( const BitArchiveItemOffset& item ) -> bool {
+    // Reading the metadata on the worker thread, which is the only one using the archive during the extraction.
+    BitArchiveEntry entry{ item.index(),
+                           item.path(),
+                           item.size(),
+                           item.packSize(),
+                           item.crc(),
+                           item.attributes(),
+                           item.lastWriteTime(),
+                           item.isEncrypted() };
+
+    std::unique_lock< std::mutex > lock{ mMutex };
+    mWorkerCondition.wait( lock, [ this ]() { return mClosed || mRequestedEntries > mStartedEntries; } );
+    if ( mClosed ) {
+        return false;
+    }
+    mEntry = std::move( entry );
+    mBufferHead = 0;
+    mBufferUsed = 0;
+    mEntryFinished = false;
+    ++mStartedEntries;
+    lock.unlock();
+    mReaderCondition.notify_all();
+    return true;
+}
+
+auto BitEntryReader::writeContent( const byte_t* data, std::size_t size ) -> bool {
+    while ( size > 0 ) {
+        std::unique_lock< std::mutex > lock{ mMutex };
+        mWorkerCondition.wait( lock, [ this ]() {
+            return mClosed || mRequestedEntries > mStartedEntries || mBufferUsed < mBuffer.size();
+        } );
+        if ( mClosed ) {
+            return false;
+        }
+        if ( mRequestedEntries > mStartedEntries ) { // The reader moved to the next entry: the content is discarded.
+            return true;
+        }
+
+        const std::size_t tail = ( mBufferHead + mBufferUsed ) % mBuffer.size();
+        const std::size_t chunkSize = std::min( { size, mBuffer.size() - mBufferUsed, mBuffer.size() - tail } );
+        std::memcpy( &mBuffer[ tail ], data, chunkSize );
+        mBufferUsed += chunkSize;
+        data += chunkSize; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        size -= chunkSize;
+        lock.unlock();
+        mReaderCondition.notify_all();
+    }
+    return true;
+}
+
+void BitEntryReader::finishEntry() {
+    {
+        const std::lock_guard< std::mutex > lock{ mMutex };
+        mEntryFinished = true;
+    }
+    mReaderCondition.notify_all();
+}
+
+auto BitEntryReader::nextEntry() -> bool {
+    std::unique_lock< std::mutex > lock{ mMutex };
+    if ( mClosed ) {
+        return false;
+    }
+    if ( mExtractionFinished && mStartedEntries < mRequestedEntries ) { // A previous call already reached the end.
+        return false;
+    }
+
+    ++mRequestedEntries;
+    if ( !mWorker.joinable() ) {
+        mWorker = std::thread{ &BitEntryReader::extractEntries, this };
+    }
+    lock.unlock();
+    mWorkerCondition.notify_all();
+
+    lock.lock();
+    mReaderCondition.wait( lock, [ this ]() { return mExtractionFinished || mStartedEntries == mRequestedEntries; } );
+    if ( mStartedEntries == mRequestedEntries ) {
+        return true;
+    }
+    if ( mExtractionError ) {
+        std::rethrow_exception( mExtractionError );
+    }
+    return false;
+}
+
+auto BitEntryReader::entry() const noexcept -> const BitArchiveEntry& {
+    return mEntry;
+}
+
+auto BitEntryReader::read( byte_t* buffer, std::size_t size ) -> std::size_t {
+    if ( size == 0 ) {
+        return 0;
+    }
+
+    std::unique_lock< std::mutex > lock{ mMutex };
+    if ( mRequestedEntries == 0 || mStartedEntries != mRequestedEntries ) { // No current entry.
+        return 0;
+    }
+
+    mReaderCondition.wait( lock, [ this ]() { return mBufferUsed > 0 || mEntryFinished || mExtractionFinished; } );
+    if ( mBufferUsed == 0 ) {
+        if ( !mEntryFinished && mExtractionError ) { // The entry was not fully extracted.
+            std::rethrow_exception( mExtractionError );
+        }
+        return 0;
+    }
+
+    std::size_t readSize = 0;
+    while ( readSize < size && mBufferUsed > 0 ) {
+        const std::size_t chunkSize = std::min( { size - readSize, mBufferUsed, mBuffer.size() - mBufferHead } );
+        std::memcpy( buffer + readSize, &mBuffer[ mBufferHead ], chunkSize ); // NOLINT(*-pro-bounds-pointer-arithmetic)
+        mBufferHead = ( mBufferHead + chunkSize ) % mBuffer.size();
+        mBufferUsed -= chunkSize;
+        readSize += chunkSize;
+    }
+    lock.unlock();
+    mWorkerCondition.notify_all();
+    return readSize;
+}
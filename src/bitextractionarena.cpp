@@ -0,0 +1,49 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "bitextractionarena.hpp"
+
+using namespace bit7z;
+
+auto BitExtractionArena::itemsCount() const noexcept -> std::size_t {
+    return mEntries.size();
+}
+
+auto BitExtractionArena::entries() const noexcept -> const std::vector< BitArenaEntry >& {
+    return mEntries;
+}
+
+auto BitExtractionArena::data() const noexcept -> const buffer_t& {
+    return mData;
+}
+
+auto BitExtractionArena::paths() const noexcept -> const tstring& {
+    return mPaths;
+}
+
+auto BitExtractionArena::path( const BitArenaEntry& entry ) const -> tstring {
+    return mPaths.substr( entry.pathOffset, entry.pathLength );
+}
+
+auto BitExtractionArena::pathData( const BitArenaEntry& entry ) const noexcept -> const tchar* {
+    return mPaths.data() + entry.pathOffset;
+}
+
+auto BitExtractionArena::itemData( const BitArenaEntry& entry ) const noexcept -> const byte_t* {
+    return mData.data() + entry.offset;
+}
+
+void BitExtractionArena::clear() noexcept {
+    mData.clear();
+    mPaths.clear();
+    mEntries.clear();
+}
@@ -18,14 +18,22 @@
 
 #include "biterror.hpp"
 #include "bitexception.hpp"
+#include "bititemstream.hpp"
+#include "internal/archivetreeindex.hpp"
+#include "internal/arenaextractcallback.hpp"
 #include "internal/bufferextractcallback.hpp"
 #include "internal/cbufferinstream.hpp"
 #include "internal/cfileinstream.hpp"
 #include "internal/cmultivolumeinstream.hpp"
 #include "internal/fileextractcallback.hpp"
 #include "internal/fixedbufferextractcallback.hpp"
+#include "internal/multibufferextractcallback.hpp"
 #include "internal/streamextractcallback.hpp"
 #include "internal/opencallback.hpp"
+#include "internal/prefixextractcallback.hpp"
+#include "internal/rangeitemsink.hpp"
+#include "internal/sinkextractcallback.hpp"
+#include "internal/spillextractcallback.hpp"
 #include "internal/stringutil.hpp"
 #include "internal/util.hpp"
 
@@ -40,16 +48,56 @@ using namespace NArchive;
 
 namespace bit7z {
 
+// Returns the indices of the items to be extracted after the given one.
+inline auto indices_after( IInArchive* inArchive, const std::vector< uint32_t >& indices, uint32_t index )
+    -> std::vector< uint32_t > {
+    if ( !indices.empty() ) {
+        const auto position = std::find( indices.cbegin(), indices.cend(), index );
+        return position != indices.cend() ? std::vector< uint32_t >( position + 1, indices.cend() )
+                                          : std::vector< uint32_t >{};
+    }
+
+    UInt32 itemsCount = 0;
+    inArchive->GetNumberOfItems( &itemsCount );
+    std::vector< uint32_t > result;
+    for ( uint32_t nextIndex = index + 1; nextIndex < itemsCount; ++nextIndex ) {
+        result.push_back( nextIndex );
+    }
+    return result;
+}
+
 void extract_arc( IInArchive* inArchive,
                   const std::vector< uint32_t >& indices,
                   ExtractCallback* extractCallback,
                   ExtractMode mode = ExtractMode::Extract ) {
-    const uint32_t* itemIndices = indices.empty() ? nullptr : indices.data();
-    const uint32_t numItems = indices.empty() ?
-                              std::numeric_limits< uint32_t >::max() : static_cast< uint32_t >( indices.size() );
+    // Loading the items' properties in windows of consecutive items, rather than querying them one by one.
+    extractCallback->prefetchItems( indices );
+
+    std::vector< uint32_t > remainingIndices;
+    const std::vector< uint32_t >* extractIndices = &indices;
+    while ( true ) {
+        const uint32_t* itemIndices = extractIndices->empty() ? nullptr : extractIndices->data();
+        const uint32_t numItems = extractIndices->empty() ?
+                                  std::numeric_limits< uint32_t >::max() :
+                                  static_cast< uint32_t >( extractIndices->size() );
+
+        const HRESULT res = inArchive->Extract( itemIndices, numItems, static_cast< Int32 >( mode ), extractCallback );
+        if ( res == S_OK ) {
+            break;
+        }
+
+        /* In continue-on-error mode, an error interrupting the whole extraction (e.g., a write error)
+         * makes only the current item fail: the extraction is restarted from the next item. */
+        uint32_t failedIndex = 0;
+        if ( res != E_ABORT && extractCallback->interruptCurrentItem( res, failedIndex ) ) {
+            remainingIndices = indices_after( inArchive, *extractIndices, failedIndex );
+            if ( remainingIndices.empty() ) { // Note: an empty vector of indices would mean extracting all the items!
+                break;
+            }
+            extractIndices = &remainingIndices;
+            continue;
+        }
 
-    const HRESULT res = inArchive->Extract( itemIndices, numItems, static_cast< Int32 >( mode ), extractCallback );
-    if ( res != S_OK ) {
         const auto& errorException = extractCallback->errorException();
         if ( errorException ) {
             std::rethrow_exception( errorException );
@@ -57,6 +105,21 @@ void extract_arc( IInArchive* inArchive,
             throw BitException( "Could not extract the archive", make_hresult_code( res ) );
         }
     }
+    extractCallback->finishExtraction();
+
+    auto& itemErrors = extractCallback->itemErrors();
+    if ( !itemErrors.empty() ) {
+        FailedFiles failedFiles;
+        failedFiles.reserve( itemErrors.size() );
+        for ( const auto& itemError : itemErrors ) {
+            failedFiles.emplace_back( itemError.path, itemError.error );
+        }
+        const auto firstError = itemErrors.front().error;
+        itemErrors.clear();
+        throw BitException( mode == ExtractMode::Test ? "Failed to test some items" : "Failed to extract some items",
+                            firstError,
+                            std::move( failedFiles ) );
+    }
 }
 
 auto BitInputArchive::openArchiveStream( const fs::path& name,
@@ -137,7 +200,8 @@ BitInputArchive::BitInputArchive( const BitAbstractArchiveHandler& handler,
                                   ArchiveStartOffset startOffset )
     : mDetectedFormat{ detect_format( handler.format(), arcPath ) },
       mArchiveHandler{ handler },
-      mArchivePath{ path_to_tstring( arcPath ) } {
+      mArchivePath{ path_to_tstring( arcPath ) },
+      mArchiveName{ mArchivePath } {
     CMyComPtr< IInStream > fileStream;
     if ( *mDetectedFormat != BitFormat::Split && arcPath.extension() == ".001" ) {
         fileStream = bit7z::make_com< CMultiVolumeInStream, IInStream >( arcPath );
@@ -165,6 +229,28 @@ BitInputArchive::BitInputArchive( const BitAbstractArchiveHandler& handler,
     mInArchive = openArchiveStream( fs::path{}, stdStream, startOffset );
 }
 
+BitInputArchive::BitInputArchive( const BitAbstractArchiveHandler& handler,
+                                  const BitInputArchive& parentArchive,
+                                  uint32_t index,
+                                  ArchiveStartOffset startOffset )
+    : mDetectedFormat{ &handler.format() }, // if auto, detect the format from content, otherwise try the passed format.
+      mArchiveHandler{ handler } {
+    if ( index >= parentArchive.itemsCount() ) {
+        throw BitException( "Cannot open the nested archive at the index " + std::to_string( index ),
+                            make_error_code( BitError::InvalidIndex ) );
+    }
+    // Note: the nested archive is not a file on the filesystem, so its path is only used for naming its items.
+    mArchiveName = parentArchive.itemAt( index ).path();
+
+    CMyComPtr< IInStream > itemStream;
+    itemStream.Attach( parentArchive.openItemStream( index ) );
+    if ( itemStream == nullptr ) { // The item must be decoded.
+        mNestedStream = std::make_unique< BitItemStream >( parentArchive, index );
+        itemStream = bit7z::make_com< CStdInStream, IInStream >( *mNestedStream );
+    }
+    mInArchive = openArchiveStream( fs::path{}, itemStream, startOffset );
+}
+
 auto BitInputArchive::archiveProperty( BitProperty property ) const -> BitPropVariant {
     BitPropVariant archiveProperty;
     const HRESULT res = mInArchive->GetArchiveProperty( static_cast<PROPID>( property ), &archiveProperty );
@@ -182,7 +268,7 @@ auto BitInputArchive::itemProperty( uint32_t index, BitProperty property ) const
                             make_hresult_code( res ) );
     }
     if ( property == BitProperty::Path && itemProperty.isEmpty() && itemsCount() == 1 ) {
-        auto itemPath = tstring_to_path( mArchivePath );
+        auto itemPath = tstring_to_path( mArchiveName );
         if ( itemPath.empty() ) {
             itemProperty = kEmptyFileWideAlias;
         } else {
@@ -219,6 +305,27 @@ auto BitInputArchive::initUpdatableArchive( IOutArchive** newArc ) const -> HRES
     return mInArchive->QueryInterface( ::IID_IOutArchive, reinterpret_cast< void** >( newArc ) );
 }
 
+auto BitInputArchive::openItemStream( uint32_t index ) const -> IInStream* {
+    CMyComPtr< IInArchiveGetStream > getStream;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if ( mInArchive->QueryInterface( ::IID_IInArchiveGetStream, reinterpret_cast< void** >( &getStream ) ) != S_OK ||
+         getStream == nullptr ) {
+        return nullptr;
+    }
+
+    CMyComPtr< ISequentialInStream > itemStream;
+    if ( getStream->GetStream( index, &itemStream ) != S_OK || itemStream == nullptr ) {
+        return nullptr;
+    }
+
+    IInStream* seekableStream = nullptr;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if ( itemStream->QueryInterface( ::IID_IInStream, reinterpret_cast< void** >( &seekableStream ) ) != S_OK ) {
+        return nullptr;
+    }
+    return seekableStream;
+}
+
 auto BitInputArchive::detectedFormat() const noexcept -> const BitInFormat& {
 #ifdef BIT7Z_AUTO_FORMAT
     // Defensive programming: for how the archive format is detected,
@@ -233,6 +340,10 @@ auto BitInputArchive::archivePath() const noexcept -> const tstring& {
     return mArchivePath;
 }
 
+auto BitInputArchive::archiveName() const noexcept -> const tstring& {
+    return mArchiveName;
+}
+
 auto BitInputArchive::handler() const noexcept -> const BitAbstractArchiveHandler& {
     return mArchiveHandler;
 }
@@ -255,9 +366,38 @@ void BitInputArchive::useFormatProperty( const wchar_t* name, const BitPropVaria
     }
 }
 
+void extract_to_directory( const BitInputArchive& inputArchive,
+                           IInArchive* inArchive,
+                           const tstring& outDir,
+                           const std::vector< uint32_t >& indices,
+                           std::vector< BitItemError >* itemErrors = nullptr ) {
+    auto callback = bit7z::make_com< FileExtractCallback >( inputArchive, outDir );
+    if ( itemErrors != nullptr ) {
+        callback->collectItemErrors( *itemErrors );
+    }
+    const auto previousErrorsCount = itemErrors != nullptr ? itemErrors->size() : 0;
+
+    if ( !callback->hasPendingItemsFilter() ) {
+        extract_arc( inArchive, indices, callback );
+        return;
+    }
+
+    /* The unchanged items, and the ones already extracted by an interrupted extraction, are excluded in advance,
+     * so that 7-Zip doesn't need to decode them at all (e.g., skipping the solid blocks containing only them). */
+    callback->prefetchItems( indices );
+    const auto pendingItems = callback->pendingItems( indices );
+    if ( !pendingItems.empty() ) { // Note: an empty vector of indices would mean extracting all the items!
+        extract_arc( inArchive, pendingItems, callback );
+    }
+
+    // The journal must be kept if some items failed, so that a later extraction can resume them.
+    if ( itemErrors == nullptr || itemErrors->size() == previousErrorsCount ) {
+        callback->completeJournal();
+    }
+}
+
 void BitInputArchive::extractTo( const tstring& outDir ) const {
-    auto callback = bit7z::make_com< FileExtractCallback, ExtractCallback >( *this, outDir );
-    extract_arc( mInArchive, {}, callback );
+    extract_to_directory( *this, mInArchive, outDir, {} );
 }
 
 inline auto findInvalidIndex( const std::vector< uint32_t >& indices,
@@ -275,8 +415,19 @@ void BitInputArchive::extractTo( const tstring& outDir, const std::vector< uint3
                             make_error_code( BitError::InvalidIndex ) );
     }
 
-    auto callback = bit7z::make_com< FileExtractCallback, ExtractCallback >( *this, outDir );
-    extract_arc( mInArchive, indices, callback );
+    extract_to_directory( *this, mInArchive, outDir, indices );
+}
+
+void BitInputArchive::extractTo( const tstring& outDir,
+                                 const std::vector< uint32_t >& indices,
+                                 std::vector< BitItemError >& itemErrors ) const {
+    const auto invalidIndex = findInvalidIndex( indices, itemsCount() );
+    if ( invalidIndex != indices.cend() ) {
+        throw BitException( "Cannot extract item at the index " + std::to_string( *invalidIndex ),
+                            make_error_code( BitError::InvalidIndex ) );
+    }
+
+    extract_to_directory( *this, mInArchive, outDir, indices, &itemErrors );
 }
 
 void BitInputArchive::extractTo( std::vector< byte_t >& outBuffer, uint32_t index ) const {
@@ -343,6 +494,243 @@ void BitInputArchive::extractTo( byte_t* buffer, std::size_t size, uint32_t inde
     extract_arc( mInArchive, indices, extractCallback );
 }
 
+/* Checks that the given indices refer to files, mapping each index to the position of the buffer for its content
+ * (i.e., the position where it is first requested); returns the unique indices in the order they are stored. */
+inline auto map_buffer_positions( const BitInputArchive& inputArchive,
+                                  const std::vector< uint32_t >& indices,
+                                  std::unordered_map< uint32_t, std::size_t >& bufferPositions ) -> vector< uint32_t > {
+    const uint32_t numberItems = inputArchive.itemsCount();
+    bufferPositions.reserve( indices.size() );
+    vector< uint32_t > uniqueIndices;
+    uniqueIndices.reserve( indices.size() );
+    for ( std::size_t position = 0; position < indices.size(); ++position ) {
+        const auto index = indices[ position ];
+        if ( index >= numberItems ) {
+            throw BitException( "Cannot extract item at the index " + std::to_string( index ),
+                                make_error_code( BitError::InvalidIndex ) );
+        }
+
+        if ( inputArchive.isItemFolder( index ) ) { // Consider only files, not folders
+            throw BitException( "Cannot extract item at the index " + std::to_string( index ) + " to the buffer",
+                                make_error_code( BitError::ItemIsAFolder ) );
+        }
+
+        if ( bufferPositions.emplace( index, position ).second ) {
+            uniqueIndices.push_back( index );
+        }
+    }
+
+    // Solid archives are decoded sequentially, so we request the items in the order they are stored.
+    std::sort( uniqueIndices.begin(), uniqueIndices.end() );
+    return uniqueIndices;
+}
+
+/* Items requested more than once are extracted only once, and then copied. */
+inline void copy_duplicate_buffers( std::vector< buffer_t >& outBuffers,
+                                    const std::vector< uint32_t >& indices,
+                                    const std::unordered_map< uint32_t, std::size_t >& bufferPositions ) {
+    for ( std::size_t position = 0; position < indices.size(); ++position ) {
+        const auto extractedPosition = bufferPositions.at( indices[ position ] );
+        if ( extractedPosition != position ) {
+            outBuffers[ position ] = outBuffers[ extractedPosition ];
+        }
+    }
+}
+
+void BitInputArchive::extractTo( std::vector< std::vector< byte_t > >& outBuffers,
+                                 const std::vector< uint32_t >& indices ) const {
+    std::unordered_map< uint32_t, std::size_t > bufferPositions;
+    const auto uniqueIndices = map_buffer_positions( *this, indices, bufferPositions );
+
+    outBuffers.clear();
+    outBuffers.resize( indices.size() );
+    if ( uniqueIndices.empty() ) { // Note: an empty vector of indices would mean extracting all the items!
+        return;
+    }
+
+    auto extractCallback = bit7z::make_com< MultiBufferExtractCallback, ExtractCallback >( *this,
+                                                                                          outBuffers,
+                                                                                          bufferPositions );
+    extract_arc( mInArchive, uniqueIndices, extractCallback );
+    copy_duplicate_buffers( outBuffers, indices, bufferPositions );
+}
+
+void BitInputArchive::extractPrefixes( std::vector< std::vector< byte_t > >& outBuffers,
+                                       std::size_t prefixSize,
+                                       const std::vector< uint32_t >& indices ) const {
+    std::unordered_map< uint32_t, std::size_t > bufferPositions;
+    const auto uniqueIndices = map_buffer_positions( *this, indices, bufferPositions );
+
+    outBuffers.clear();
+    outBuffers.resize( indices.size() );
+    if ( uniqueIndices.empty() || prefixSize == 0 ) {
+        return;
+    }
+
+    /* In non-solid archives, the extraction is aborted as soon as the prefix of an item is complete,
+     * and then it is resumed from the next item, so that the rest of the item is never decoded.
+     * In solid archives, resuming would mean decoding the solid block again from its start,
+     * so the rest of the items is discarded, and only the last item stops the extraction. */
+    const BitPropVariant isSolid = archiveProperty( BitProperty::Solid );
+    const bool abortWhenFull = !( isSolid.isBool() && isSolid.getBool() );
+    auto extractCallback = bit7z::make_com< PrefixExtractCallback >( *this,
+                                                                     outBuffers,
+                                                                     bufferPositions,
+                                                                     prefixSize,
+                                                                     abortWhenFull,
+                                                                     uniqueIndices.back() );
+    auto nextIndex = uniqueIndices.cbegin();
+    while ( nextIndex != uniqueIndices.cend() ) {
+        const vector< uint32_t > remainingIndices( nextIndex, uniqueIndices.cend() );
+        try {
+            extract_arc( mInArchive, remainingIndices, extractCallback );
+            break;
+        } catch ( const BitException& ) {
+            // Note: until it starts extracting the first remaining item, the callback still refers to the last abort.
+            if ( !extractCallback->abortedWhenFull() || extractCallback->currentIndex() < remainingIndices.front() ) {
+                throw;
+            }
+        }
+        nextIndex = std::upper_bound( nextIndex, uniqueIndices.cend(), extractCallback->currentIndex() );
+    }
+    copy_duplicate_buffers( outBuffers, indices, bufferPositions );
+}
+
+void BitInputArchive::extractTo( BitExtractionArena& outArena, const std::vector< uint32_t >& indices ) const {
+    const auto invalidIndex = findInvalidIndex( indices, itemsCount() );
+    if ( invalidIndex != indices.cend() ) {
+        throw BitException( "Cannot extract item at the index " + std::to_string( *invalidIndex ),
+                            make_error_code( BitError::InvalidIndex ) );
+    }
+
+    auto extractCallback = bit7z::make_com< ArenaExtractCallback >( *this, outArena );
+    extractCallback->prefetchItems( indices );
+    const auto filesIndices = extractCallback->prepareArena( indices );
+    if ( !filesIndices.empty() ) { // Note: an empty vector of indices would mean extracting all the items!
+        extract_arc( mInArchive, filesIndices, extractCallback );
+    }
+}
+
+void BitInputArchive::extractTo( const ItemSinkFactory& sinkFactory, const std::vector< uint32_t >& indices ) const {
+    const auto invalidIndex = findInvalidIndex( indices, itemsCount() );
+    if ( invalidIndex != indices.cend() ) {
+        throw BitException( "Cannot extract item at the index " + std::to_string( *invalidIndex ),
+                            make_error_code( BitError::InvalidIndex ) );
+    }
+
+    auto extractCallback = bit7z::make_com< SinkExtractCallback >( *this, sinkFactory );
+    try {
+        extract_arc( mInArchive, indices, extractCallback );
+    } catch ( const BitException& ) {
+        // If the extraction was aborted by the user's factory or sinks, we rethrow their exception.
+        if ( extractCallback->sinkException() ) {
+            std::rethrow_exception( extractCallback->sinkException() );
+        }
+        throw;
+    }
+}
+
+/* Reads the given range of an item directly from the item's stream, if the archive handler can provide it;
+ * returns false if the item's content must be decoded instead. */
+inline auto read_range_from_stream( IInArchive* inArchive,
+                                    uint32_t index,
+                                    uint64_t offset,
+                                    uint64_t length,
+                                    BitItemSink& sink ) -> bool {
+    CMyComPtr< IInArchiveGetStream > getStream;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    HRESULT res = inArchive->QueryInterface( ::IID_IInArchiveGetStream, reinterpret_cast< void** >( &getStream ) );
+    if ( res != S_OK || getStream == nullptr ) {
+        return false;
+    }
+
+    CMyComPtr< ISequentialInStream > itemStream;
+    res = getStream->GetStream( index, &itemStream );
+    if ( res != S_OK || itemStream == nullptr ) { // e.g., the item is compressed or encrypted.
+        return false;
+    }
+
+    constexpr auto kChunkSize = static_cast< std::size_t >( 64 * 1024 );
+    buffer_t chunk( kChunkSize );
+
+    CMyComPtr< IInStream > seekableStream;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if ( itemStream->QueryInterface( ::IID_IInStream, reinterpret_cast< void** >( &seekableStream ) ) == S_OK ) {
+        res = seekableStream->Seek( static_cast< Int64 >( offset ), STREAM_SEEK_SET, nullptr );
+        if ( res != S_OK ) {
+            throw BitException( "Could not seek the item's stream", make_hresult_code( res ) );
+        }
+    } else {
+        // The stream is sequential, so the data before the range is skipped.
+        for ( uint64_t skipSize = offset; skipSize > 0; ) {
+            UInt32 readSize = 0;
+            const auto chunkSize = static_cast< UInt32 >( std::min< uint64_t >( skipSize, kChunkSize ) );
+            res = itemStream->Read( chunk.data(), chunkSize, &readSize );
+            if ( res != S_OK ) {
+                throw BitException( "Could not read the item's stream", make_hresult_code( res ) );
+            }
+            if ( readSize == 0 ) {
+                break;
+            }
+            skipSize -= readSize;
+        }
+    }
+
+    for ( uint64_t remainingSize = length; remainingSize > 0; ) {
+        UInt32 readSize = 0;
+        const auto chunkSize = static_cast< UInt32 >( std::min< uint64_t >( remainingSize, kChunkSize ) );
+        res = itemStream->Read( chunk.data(), chunkSize, &readSize );
+        if ( res != S_OK ) {
+            throw BitException( "Could not read the item's stream", make_hresult_code( res ) );
+        }
+        if ( readSize == 0 ) { // The item ended before the end of the range.
+            break;
+        }
+        if ( !sink.write( chunk.data(), readSize ) ) {
+            throw BitException( "Could not extract the item's range", make_hresult_code( E_ABORT ) );
+        }
+        remainingSize -= readSize;
+    }
+    sink.finish();
+    return true;
+}
+
+void BitInputArchive::extractRange( uint32_t index, uint64_t offset, uint64_t length, BitItemSink& sink ) const {
+    if ( index >= itemsCount() ) {
+        throw BitException( "Cannot extract item at the index " + std::to_string( index ),
+                            make_error_code( BitError::InvalidIndex ) );
+    }
+
+    if ( isItemFolder( index ) ) {
+        throw BitException( "Cannot extract item at the index " + std::to_string( index ) + " to the sink",
+                            make_error_code( BitError::ItemIsAFolder ) );
+    }
+
+    if ( length == 0 ) {
+        sink.finish();
+        return;
+    }
+
+    if ( read_range_from_stream( mInArchive, index, offset, length, sink ) ) {
+        return;
+    }
+
+    bool rangeCompleted = false;
+    try {
+        extractTo( [ & ]( const BitArchiveItemOffset& ) -> std::unique_ptr< BitItemSink > {
+            return std::make_unique< RangeItemSink >( sink, offset, length, rangeCompleted );
+        }, { index } );
+    } catch ( const BitException& ) {
+        if ( !rangeCompleted ) {
+            throw;
+        }
+    }
+
+    if ( rangeCompleted ) { // The extraction was aborted by the range sink, so the sink was not finished yet.
+        sink.finish();
+    }
+}
+
 void BitInputArchive::extractTo( std::map< tstring, std::vector< byte_t > >& outMap ) const {
     const uint32_t numberItems = itemsCount();
     vector< uint32_t > filesIndices;
@@ -356,6 +744,25 @@ void BitInputArchive::extractTo( std::map< tstring, std::vector< byte_t > >& out
     extract_arc( mInArchive, filesIndices, extractCallback );
 }
 
+void BitInputArchive::extractTo( std::map< tstring, BitItemContent >& outMap,
+                                 uint64_t itemMemoryThreshold,
+                                 uint64_t memoryBudget,
+                                 const tstring& spillDirectory ) const {
+    const uint32_t numberItems = itemsCount();
+    vector< uint32_t > filesIndices;
+    for ( uint32_t i = 0; i < numberItems; ++i ) {
+        if ( !isItemFolder( i ) ) { // Consider only files, not folders
+            filesIndices.push_back( i );
+        }
+    }
+
+    SpillPolicy policy{ itemMemoryThreshold, memoryBudget, tstring_to_path( spillDirectory ), 0 };
+    auto extractCallback = bit7z::make_com< SpillExtractCallback, ExtractCallback >( *this,
+                                                                                    outMap,
+                                                                                    std::move( policy ) );
+    extract_arc( mInArchive, filesIndices, extractCallback );
+}
+
 void BitInputArchive::test() const {
     map< tstring, vector< byte_t > > dummyMap; // output map (not used since we are testing!)
     auto extractCallback = bit7z::make_com< BufferExtractCallback, ExtractCallback >( *this, dummyMap );
@@ -385,6 +792,10 @@ BitInputArchive::~BitInputArchive() {
     }
 }
 
+auto BitInputArchive::prefetchedItems( ItemsTableColumns columns, uint32_t windowSize ) const -> BitPrefetchedItems {
+    return BitPrefetchedItems{ *this, columns, windowSize };
+}
+
 auto BitInputArchive::begin() const noexcept -> BitInputArchive::ConstIterator {
     return ConstIterator{ 0, *this };
 }
@@ -404,16 +815,76 @@ auto BitInputArchive::cend() const noexcept -> BitInputArchive::ConstIterator {
     return end();
 }
 
+namespace {
+#ifdef _WIN32
+// On Windows, both slashes and backslashes are path separators, so we use only one of them in the index.
+auto normalized_path( tstring path ) -> tstring {
+    std::replace( path.begin(), path.end(), BIT7Z_STRING( '/' ), BIT7Z_STRING( '\\' ) );
+    return path;
+}
+#else
+inline auto normalized_path( const tstring& path ) -> const tstring& {
+    return path;
+}
+#endif
+} // namespace
+
+auto BitInputArchive::pathIndex() const -> const std::unordered_map< tstring, uint32_t >& {
+    /* Note: the lock guards only the creation of the index; once created, the index is never modified,
+     * so the callers can read the returned reference without holding the lock. */
+    const std::lock_guard< std::mutex > lock{ mPathIndexMutex };
+    if ( mPathIndex == nullptr ) {
+        const uint32_t count = itemsCount();
+        auto pathIndex = std::make_unique< std::unordered_map< tstring, uint32_t > >();
+        pathIndex->reserve( count );
+        for ( uint32_t index = 0; index < count; ++index ) {
+            // Note: if an archive contains the same path more than once, we keep the first item, as std::find_if did.
+            pathIndex->emplace( normalized_path( BitArchiveItemOffset{ index, *this }.path() ), index );
+        }
+        mPathIndex = std::move( pathIndex );
+    }
+    return *mPathIndex;
+}
+
 auto BitInputArchive::find( const tstring& path ) const noexcept -> BitInputArchive::ConstIterator {
-    return std::find_if( begin(), end(), [ &path ]( auto& oldItem ) {
-        return oldItem.path() == path;
-    } );
+    try {
+        const auto& index = pathIndex();
+        const auto item = index.find( normalized_path( path ) );
+        return item != index.end() ? ConstIterator{ item->second, *this } : end();
+    } catch ( ... ) {
+        // The index could not be built (e.g., out of memory), so we fall back to searching the item linearly.
+        // Note: the paths are normalized as in the index, so that both lookups find the same items.
+        const auto& normalizedPath = normalized_path( path );
+        return std::find_if( begin(), end(), [ &normalizedPath ]( auto& oldItem ) {
+            return normalized_path( oldItem.path() ) == normalizedPath;
+        } );
+    }
 }
 
 auto BitInputArchive::contains( const tstring& path ) const noexcept -> bool {
     return find( path ) != end();
 }
 
+auto BitInputArchive::treeIndex() const -> const ArchiveTreeIndex& {
+    const std::lock_guard< std::mutex > lock{ mTreeIndexMutex };
+    if ( mTreeIndex == nullptr ) {
+        mTreeIndex = std::make_unique< ArchiveTreeIndex >( *this );
+    }
+    return *mTreeIndex;
+}
+
+auto BitInputArchive::listDirectory( const tstring& path ) const -> std::vector< BitDirectoryEntry > {
+    const auto& index = treeIndex();
+    const auto node = index.findNode( path );
+    return node != ArchiveTreeIndex::kNotFound ? index.listNode( node ) : std::vector< BitDirectoryEntry >{};
+}
+
+auto BitInputArchive::subtree( const tstring& path ) const -> std::vector< uint32_t > {
+    const auto& index = treeIndex();
+    const auto node = index.findNode( path );
+    return node != ArchiveTreeIndex::kNotFound ? index.subtreeItems( node ) : std::vector< uint32_t >{};
+}
+
 auto BitInputArchive::itemAt( uint32_t index ) const -> BitArchiveItemOffset {
     const uint32_t numberItems = itemsCount();
     if ( index >= numberItems ) {
@@ -0,0 +1,54 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "bititemcontent.hpp"
+#include "internal/cbufferstreambuf.hpp"
+
+using namespace bit7z;
+
+BitItemContent::BitItemContent() : mSize{ 0 } {}
+
+// Note: moving a vector keeps its data, so the stream buffers still refer to the moved content.
+BitItemContent::BitItemContent( BitItemContent&& ) noexcept = default;
+
+auto BitItemContent::operator=( BitItemContent&& ) noexcept -> BitItemContent& = default;
+
+BitItemContent::~BitItemContent() = default;
+
+auto BitItemContent::isInMemory() const noexcept -> bool {
+    return mSpillFile == nullptr;
+}
+
+auto BitItemContent::size() const noexcept -> uint64_t {
+    return mSize;
+}
+
+auto BitItemContent::buffer() const noexcept -> const buffer_t& {
+    return mBuffer;
+}
+
+auto BitItemContent::stream() -> std::istream& {
+    std::streambuf* contentBuffer = mSpillFile.get();
+    if ( contentBuffer == nullptr ) {
+        if ( mBufferStreamBuf == nullptr ) {
+            mBufferStreamBuf = std::make_unique< CBufferStreamBuf >( mBuffer );
+        }
+        contentBuffer = mBufferStreamBuf.get();
+    }
+
+    if ( mStream == nullptr ) {
+        mStream = std::make_unique< std::istream >( contentBuffer );
+    }
+    mStream->rdbuf( contentBuffer ); // Note: this also clears the stream's error state.
+    mStream->seekg( 0 );
+    return *mStream;
+}
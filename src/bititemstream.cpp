@@ -0,0 +1,78 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <ostream>
+
+#include "biterror.hpp"
+#include "bitexception.hpp"
+#include "bititemstream.hpp"
+#include "internal/cbufferstreambuf.hpp"
+#include "internal/cinstreambuf.hpp"
+#include "internal/stringutil.hpp"
+#include "internal/tempfilebuf.hpp"
+
+using namespace bit7z;
+
+BitItemStream::BitItemStream( const BitInputArchive& inputArchive,
+                              uint32_t index,
+                              uint64_t maxMemorySize,
+                              const tstring& spillDirectory )
+    : std::istream{ nullptr }, mSize{ 0 }, mIsDirect{ false } {
+    if ( index >= inputArchive.itemsCount() ) {
+        throw BitException( "Cannot open the stream of the item at the index " + std::to_string( index ),
+                            make_error_code( BitError::InvalidIndex ) );
+    }
+
+    if ( inputArchive.isItemFolder( index ) ) {
+        throw BitException( "Cannot open the stream of the item at the index " + std::to_string( index ),
+                            make_error_code( BitError::ItemIsAFolder ) );
+    }
+
+    CMyComPtr< IInStream > itemStream;
+    itemStream.Attach( inputArchive.openItemStream( index ) );
+    if ( itemStream != nullptr ) {
+        UInt64 streamSize = 0;
+        if ( itemStream->Seek( 0, STREAM_SEEK_END, &streamSize ) == S_OK &&
+             itemStream->Seek( 0, STREAM_SEEK_SET, nullptr ) == S_OK ) {
+            mItemBuffer = std::make_unique< CInStreamBuf >( itemStream );
+            mSize = streamSize;
+            mIsDirect = true;
+        }
+    }
+
+    if ( mItemBuffer == nullptr ) {
+        const BitPropVariant itemSize = inputArchive.itemProperty( index, BitProperty::Size );
+        if ( !itemSize.isEmpty() && itemSize.getUInt64() <= maxMemorySize ) {
+            inputArchive.extractTo( mItemContent, index );
+            mSize = mItemContent.size();
+            mItemBuffer = std::make_unique< CBufferStreamBuf >( mItemContent );
+        } else { // The size of the item is too big (or unknown), so we spill its content to a temporary file.
+            auto tempFile = std::make_unique< TempFileBuf >( tstring_to_path( spillDirectory ) );
+            std::ostream tempStream{ tempFile.get() };
+            inputArchive.extractTo( tempStream, index );
+            mSize = static_cast< uint64_t >( tempFile->pubseekoff( 0, std::ios_base::end, std::ios_base::in ) );
+            tempFile->pubseekpos( 0, std::ios_base::in );
+            mItemBuffer = std::move( tempFile );
+        }
+    }
+    rdbuf( mItemBuffer.get() );
+}
+
+BitItemStream::~BitItemStream() = default;
+
+auto BitItemStream::size() const noexcept -> uint64_t {
+    return mSize;
+}
+
+auto BitItemStream::isDirect() const noexcept -> bool {
+    return mIsDirect;
+}
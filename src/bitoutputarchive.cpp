@@ -253,7 +253,7 @@ void BitOutputArchive::compressTo( const tstring& outFile ) {
         if ( overwriteMode == OverwriteMode::Skip ) { // Skipping if the output file already exists
             return;
         }
-        if ( overwriteMode == OverwriteMode::Overwrite && !fs::remove( outPath, error ) ) {
+        if ( overwriteMode != OverwriteMode::None && !fs::remove( outPath, error ) ) {
             throw BitException( "Failed to delete the old archive file", error, outFile );
         }
         // Note: if overwriteMode is OverwriteMode::None, an exception will be thrown by the CFileOutStream constructor
@@ -270,7 +270,7 @@ void BitOutputArchive::compressTo( std::vector< byte_t >& outBuffer ) {
         if ( overwriteMode == OverwriteMode::Skip ) {
             return;
         }
-        if ( overwriteMode == OverwriteMode::Overwrite ) {
+        if ( overwriteMode != OverwriteMode::None ) {
             outBuffer.clear();
         } else {
             throw BitException( "Cannot compress to buffer", make_error_code( BitError::NonEmptyOutputBuffer ) );
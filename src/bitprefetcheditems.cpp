@@ -0,0 +1,161 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+
+#include "bitprefetcheditems.hpp"
+#include "bitinputarchive.hpp"
+
+using namespace bit7z;
+
+BitPrefetchedItem::BitPrefetchedItem( const BitPrefetchedItems& items, uint32_t index ) noexcept
+    : mItems{ &items }, mIndex{ index } {}
+
+auto BitPrefetchedItem::window() const -> const BitArchiveItemsTable& {
+    return mItems->mWindow;
+}
+
+auto BitPrefetchedItem::row() const -> uint32_t {
+    return mItems->windowRow( mIndex );
+}
+
+auto BitPrefetchedItem::index() const noexcept -> uint32_t {
+    return mIndex;
+}
+
+auto BitPrefetchedItem::isDir() const -> bool {
+    const auto itemRow = row();
+    return window().isDir( itemRow );
+}
+
+auto BitPrefetchedItem::path() const -> tstring {
+    const auto itemRow = row();
+    return window().path( itemRow );
+}
+
+auto BitPrefetchedItem::pathData() const -> const tchar* {
+    const auto itemRow = row();
+    return window().pathData( itemRow );
+}
+
+auto BitPrefetchedItem::pathLength() const -> std::size_t {
+    const auto itemRow = row();
+    return window().pathLength( itemRow );
+}
+
+auto BitPrefetchedItem::size() const -> uint64_t {
+    const auto itemRow = row();
+    return window().size( itemRow );
+}
+
+auto BitPrefetchedItem::packSize() const -> uint64_t {
+    const auto itemRow = row();
+    return window().packSize( itemRow );
+}
+
+auto BitPrefetchedItem::hasLastWriteTime() const -> bool {
+    const auto itemRow = row();
+    return window().hasLastWriteTime( itemRow );
+}
+
+auto BitPrefetchedItem::lastWriteTime() const -> time_type {
+    const auto itemRow = row();
+    return window().lastWriteTime( itemRow );
+}
+
+auto BitPrefetchedItem::hasCrc() const -> bool {
+    const auto itemRow = row();
+    return window().hasCrc( itemRow );
+}
+
+auto BitPrefetchedItem::crc() const -> uint32_t {
+    const auto itemRow = row();
+    return window().crc( itemRow );
+}
+
+auto BitPrefetchedItem::attributes() const -> uint32_t {
+    const auto itemRow = row();
+    return window().attributes( itemRow );
+}
+
+auto BitPrefetchedItem::isEncrypted() const -> bool {
+    const auto itemRow = row();
+    return window().isEncrypted( itemRow );
+}
+
+BitPrefetchedItems::BitPrefetchedItems( const BitInputArchive& archive,
+                                        ItemsTableColumns columns,
+                                        uint32_t windowSize )
+    : mArchive{ &archive },
+      mItemsCount{ archive.itemsCount() },
+      mWindowSize{ windowSize > 0 ? windowSize : kDefaultWindowSize },
+      mWindow{ columns, std::min( mWindowSize, mItemsCount ) },
+      mWindowStart{ 0 } {}
+
+auto BitPrefetchedItems::windowRow( uint32_t index ) const -> uint32_t {
+    if ( index < mWindowStart || index - mWindowStart >= mWindow.itemsCount() ) {
+        // Note: the window is cleared first, so that it is left empty (and hence reloaded) if addItem throws.
+        mWindow.clear();
+        mWindowStart = index;
+        const uint32_t windowEnd = index + std::min( mWindowSize, mItemsCount - std::min( index, mItemsCount ) );
+        for ( uint32_t item = index; item < windowEnd; ++item ) {
+            mWindow.addItem( *mArchive, item );
+        }
+    }
+    return index - mWindowStart; // If the index is not valid, the window is empty, and the table throws.
+}
+
+auto BitPrefetchedItems::begin() const noexcept -> BitPrefetchedItems::ConstIterator {
+    return ConstIterator{ *this, 0 };
+}
+
+auto BitPrefetchedItems::end() const noexcept -> BitPrefetchedItems::ConstIterator {
+    return ConstIterator{ *this, mItemsCount };
+}
+
+auto BitPrefetchedItems::columns() const noexcept -> ItemsTableColumns {
+    return mWindow.columns();
+}
+
+auto BitPrefetchedItems::windowSize() const noexcept -> uint32_t {
+    return mWindowSize;
+}
+
+BitPrefetchedItems::ConstIterator::ConstIterator( const BitPrefetchedItems& items, uint32_t index ) noexcept
+    : mItem{ items, index } {}
+
+auto BitPrefetchedItems::ConstIterator::operator++() noexcept -> BitPrefetchedItems::ConstIterator& {
+    ++mItem.mIndex;
+    return *this;
+}
+
+auto BitPrefetchedItems::ConstIterator::operator++( int ) noexcept -> BitPrefetchedItems::ConstIterator {
+    ConstIterator incrementedIterator = *this;
+    ++( *this );
+    return incrementedIterator;
+}
+
+auto BitPrefetchedItems::ConstIterator::operator==( const ConstIterator& other ) const noexcept -> bool {
+    return mItem.mItems == other.mItem.mItems && mItem.mIndex == other.mItem.mIndex;
+}
+
+auto BitPrefetchedItems::ConstIterator::operator!=( const ConstIterator& other ) const noexcept -> bool {
+    return !( *this == other );
+}
+
+auto BitPrefetchedItems::ConstIterator::operator*() const noexcept -> BitPrefetchedItems::ConstIterator::reference {
+    return mItem;
+}
+
+auto BitPrefetchedItems::ConstIterator::operator->() const noexcept -> BitPrefetchedItems::ConstIterator::pointer {
+    return &mItem;
+}
@@ -0,0 +1,166 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/archivetreeindex.hpp"
+#include "internal/stringutil.hpp"
+
+namespace bit7z {
+
+namespace {
+inline auto child_key( uint32_t parent, uint32_t name ) -> uint64_t {
+    return ( static_cast< uint64_t >( parent ) << 32u ) | name;
+}
+
+/**
+ * Calls the given function for each component of the given path, skipping empty and "." components.
+ *
+ * @return false if the function returned false for any component, true otherwise.
+ */
+template< typename Function >
+auto for_each_component( const tstring& path, Function function ) -> bool {
+    std::size_t begin = 0;
+    while ( begin < path.size() ) {
+        std::size_t end = begin;
+        while ( end < path.size() && !isPathSeparator( path[ end ] ) ) {
+            ++end;
+        }
+        const std::size_t length = end - begin;
+        if ( length > 0 && !( length == 1 && path[ begin ] == BIT7Z_STRING( '.' ) ) ) {
+            if ( !function( path.substr( begin, length ) ) ) {
+                return false;
+            }
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+inline auto is_dot_dot( const tstring& component ) -> bool {
+    return component == BIT7Z_STRING( ".." );
+}
+} // namespace
+
+ArchiveTreeIndex::ArchiveTreeIndex( const BitInputArchive& archive ) {
+    const uint32_t count = archive.itemsCount();
+    mNextItem.resize( count, kNotFound );
+    mNodes.push_back( { kNotFound, kNotFound, kNotFound, kNotFound, kNotFound, kNotFound, kNotFound, true } );
+
+    for ( uint32_t index = 0; index < count; ++index ) {
+        const auto item = archive.itemAt( index );
+
+        uint32_t node = 0;
+        for_each_component( item.path(), [ this, &node ]( const tstring& component ) -> bool {
+            if ( is_dot_dot( component ) ) {
+                node = node == 0 ? 0 : mNodes[ node ].parent;
+            } else {
+                node = addChild( node, internName( component ) );
+            }
+            return true;
+        } );
+
+        auto& itemNode = mNodes[ node ];
+        if ( itemNode.firstItem == kNotFound ) {
+            itemNode.firstItem = index;
+        } else {
+            mNextItem[ itemNode.lastItem ] = index;
+        }
+        itemNode.lastItem = index;
+        itemNode.isDir = itemNode.isDir || item.isDir();
+    }
+}
+
+auto ArchiveTreeIndex::internName( const tstring& name ) -> uint32_t {
+    const auto result = mNameIds.emplace( name, static_cast< uint32_t >( mNames.size() ) );
+    if ( result.second ) {
+        mNames.push_back( name );
+    }
+    return result.first->second;
+}
+
+auto ArchiveTreeIndex::addChild( uint32_t parent, uint32_t name ) -> uint32_t {
+    const auto newNode = static_cast< uint32_t >( mNodes.size() );
+    const auto result = mChildNodes.emplace( child_key( parent, name ), newNode );
+    if ( !result.second ) {
+        return result.first->second;
+    }
+
+    mNodes.push_back( { name, parent, kNotFound, kNotFound, kNotFound, kNotFound, kNotFound, false } );
+    auto& parentNode = mNodes[ parent ];
+    if ( parentNode.firstChild == kNotFound ) {
+        parentNode.firstChild = newNode;
+    } else {
+        mNodes[ parentNode.lastChild ].nextSibling = newNode;
+    }
+    parentNode.lastChild = newNode;
+    parentNode.isDir = true; // A node having children is a directory, even if the archive has no item for it.
+    return newNode;
+}
+
+auto ArchiveTreeIndex::findChild( uint32_t parent, const tstring& name ) const -> uint32_t {
+    const auto nameId = mNameIds.find( name );
+    if ( nameId == mNameIds.end() ) {
+        return kNotFound;
+    }
+    const auto child = mChildNodes.find( child_key( parent, nameId->second ) );
+    return child != mChildNodes.end() ? child->second : kNotFound;
+}
+
+auto ArchiveTreeIndex::findNode( const tstring& path ) const -> uint32_t {
+    uint32_t node = 0;
+    const bool found = for_each_component( path, [ this, &node ]( const tstring& component ) -> bool {
+        if ( is_dot_dot( component ) ) {
+            node = mNodes[ node ].parent; // Note: the parent of the root node is kNotFound.
+        } else {
+            node = findChild( node, component );
+        }
+        return node != kNotFound;
+    } );
+    return found ? node : kNotFound;
+}
+
+auto ArchiveTreeIndex::nodeItems( uint32_t node ) const -> std::vector< uint32_t > {
+    std::vector< uint32_t > result;
+    for ( auto item = mNodes[ node ].firstItem; item != kNotFound; item = mNextItem[ item ] ) {
+        result.push_back( item );
+    }
+    return result;
+}
+
+auto ArchiveTreeIndex::subtreeItems( uint32_t node ) const -> std::vector< uint32_t > {
+    std::vector< uint32_t > result;
+    std::vector< uint32_t > pendingNodes;
+    for ( auto child = mNodes[ node ].firstChild; child != kNotFound; child = mNodes[ child ].nextSibling ) {
+        pendingNodes.push_back( child );
+    }
+    while ( !pendingNodes.empty() ) {
+        const auto current = pendingNodes.back();
+        pendingNodes.pop_back();
+        for ( auto item = mNodes[ current ].firstItem; item != kNotFound; item = mNextItem[ item ] ) {
+            result.push_back( item );
+        }
+        for ( auto child = mNodes[ current ].firstChild; child != kNotFound; child = mNodes[ child ].nextSibling ) {
+            pendingNodes.push_back( child );
+        }
+    }
+    return result;
+}
+
+auto ArchiveTreeIndex::listNode( uint32_t node ) const -> std::vector< BitDirectoryEntry > {
+    std::vector< BitDirectoryEntry > result;
+    for ( auto child = mNodes[ node ].firstChild; child != kNotFound; child = mNodes[ child ].nextSibling ) {
+        const auto& childNode = mNodes[ child ];
+        result.push_back( { mNames[ childNode.name ], childNode.firstItem, childNode.isDir } );
+    }
+    return result;
+}
+
+} // namespace bit7z
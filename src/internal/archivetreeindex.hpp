@@ -0,0 +1,85 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ARCHIVETREEINDEX_HPP
+#define ARCHIVETREEINDEX_HPP
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "bitinputarchive.hpp"
+
+namespace bit7z {
+
+/**
+ * An in-memory tree of the directories of an archive, built in a single pass over the items' paths.
+ *
+ * Each node of the tree is a path component (interned, so that equal names are stored only once),
+ * and it refers to the archive items having the node's path (if any; e.g., the directories of ZIP archives
+ * are often implied by the paths of their content).
+ * All the queries take time proportional to the size of their result.
+ */
+class ArchiveTreeIndex final {
+    public:
+        static constexpr auto kNotFound = std::numeric_limits< uint32_t >::max();
+
+        explicit ArchiveTreeIndex( const BitInputArchive& archive );
+
+        /**
+         * @return the node having the given path (the root node, if the path is empty),
+         *         or kNotFound if no item in the archive has or is inside the path.
+         */
+        BIT7Z_NODISCARD auto findNode( const tstring& path ) const -> uint32_t;
+
+        /**
+         * @return the indices of the archive items having the path of the given node.
+         */
+        BIT7Z_NODISCARD auto nodeItems( uint32_t node ) const -> std::vector< uint32_t >;
+
+        /**
+         * @return the indices of the archive items inside the given node, recursively.
+         */
+        BIT7Z_NODISCARD auto subtreeItems( uint32_t node ) const -> std::vector< uint32_t >;
+
+        /**
+         * @return the entries directly inside the given node.
+         */
+        BIT7Z_NODISCARD auto listNode( uint32_t node ) const -> std::vector< BitDirectoryEntry >;
+
+    private:
+        struct Node {
+            uint32_t name;
+            uint32_t parent;
+            uint32_t firstChild;
+            uint32_t lastChild;
+            uint32_t nextSibling;
+            uint32_t firstItem;
+            uint32_t lastItem;
+            bool isDir;
+        };
+
+        std::vector< Node > mNodes; // Note: the first node is the root of the tree.
+        std::vector< uint32_t > mNextItem; // For each archive item, the next item having the same path.
+
+        std::vector< tstring > mNames;
+        std::unordered_map< tstring, uint32_t > mNameIds;
+        std::unordered_map< uint64_t, uint32_t > mChildNodes; // (parent node, name) -> child node
+
+        auto internName( const tstring& name ) -> uint32_t;
+
+        auto addChild( uint32_t parent, uint32_t name ) -> uint32_t;
+
+        BIT7Z_NODISCARD auto findChild( uint32_t parent, const tstring& name ) const -> uint32_t;
+};
+
+}  // namespace bit7z
+
+#endif //ARCHIVETREEINDEX_HPP
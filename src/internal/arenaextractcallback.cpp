@@ -0,0 +1,122 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+
+#include "biterror.hpp"
+#include "bitexception.hpp"
+#include "internal/arenaextractcallback.hpp"
+#include "internal/cbufferoutstream.hpp"
+#include "internal/cfixedbufferoutstream.hpp"
+#include "internal/stringutil.hpp"
+#include "internal/util.hpp"
+
+namespace bit7z {
+
+ArenaExtractCallback::ArenaExtractCallback( const BitInputArchive& inputArchive, BitExtractionArena& arena )
+    : ExtractCallback( inputArchive ),
+      mArena( arena ),
+      mPendingEntry{ 0 },
+      mHasPendingEntry{ false } {}
+
+auto ArenaExtractCallback::prepareArena( const std::vector< uint32_t >& indices ) -> std::vector< uint32_t > {
+    mArena.clear();
+    mEntryPositions.clear();
+    mIsEntrySized.clear();
+
+    const uint32_t itemsCount = indices.empty() ? inputArchive().itemsCount() : static_cast< uint32_t >( indices.size() );
+    std::vector< uint32_t > filesIndices;
+    filesIndices.reserve( itemsCount );
+    std::size_t dataSize = 0;
+    for ( uint32_t i = 0; i < itemsCount; ++i ) {
+        const uint32_t index = indices.empty() ? i : indices[ i ];
+        const auto& processedItem = item( index );
+        if ( processedItem.isDir() || !mEntryPositions.emplace( index, mArena.mEntries.size() ).second ) {
+            continue;
+        }
+
+        const fs::path& itemPath = processedItem.path();
+        const tstring path = itemPath.empty() ? tstring{ kEmptyFileAlias } : path_to_tstring( itemPath );
+        const bool isSized = processedItem.hasSize();
+        const auto itemSize = isSized ? processedItem.size() : 0;
+        if ( itemSize > mArena.mData.max_size() - dataSize ) {
+            throw BitException( "Cannot extract the items to the arena",
+                                make_hresult_code( E_OUTOFMEMORY ) );
+        }
+
+        mArena.mEntries.push_back( { index, mArena.mPaths.size(), path.size(), dataSize, static_cast< std::size_t >( itemSize ) } );
+        mArena.mPaths += path;
+        mIsEntrySized.push_back( isSized );
+        dataSize += static_cast< std::size_t >( itemSize );
+        filesIndices.push_back( index );
+    }
+
+    mArena.mData.resize( dataSize ); // The only allocation of the arena's data (if all the sizes are known).
+
+    // Solid archives are decoded sequentially, so we request the items in the order they are stored.
+    std::sort( filesIndices.begin(), filesIndices.end() );
+    return filesIndices;
+}
+
+void ArenaExtractCallback::releaseStream() {
+    mOutMemStream.Release();
+}
+
+auto ArenaExtractCallback::finishOperation( OperationResult operationResult ) -> HRESULT {
+    if ( mHasPendingEntry ) {
+        mHasPendingEntry = false;
+        releaseStream();
+        if ( operationResult == OperationResult::Success && extractMode() == ExtractMode::Extract ) {
+            auto& entry = mArena.mEntries[ mPendingEntry ];
+            entry.offset = mArena.mData.size();
+            entry.size = mPendingBuffer.size();
+            mArena.mData.insert( mArena.mData.end(), mPendingBuffer.cbegin(), mPendingBuffer.cend() );
+        }
+        mPendingBuffer.clear();
+    }
+    return ExtractCallback::finishOperation( operationResult );
+}
+
+auto ArenaExtractCallback::getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT {
+    const auto entryPosition = mEntryPositions.find( index );
+    if ( entryPosition == mEntryPositions.end() ) {
+        return S_OK;
+    }
+
+    const auto& entry = mArena.mEntries[ entryPosition->second ];
+    if ( mHandler.fileCallback() ) {
+        mHandler.fileCallback()( mArena.path( entry ) );
+    }
+
+    if ( !mIsEntrySized[ entryPosition->second ] ) {
+        mPendingEntry = entryPosition->second;
+        mHasPendingEntry = true;
+        auto outStreamLoc = bit7z::make_com< CBufferOutStream, ISequentialOutStream >( mPendingBuffer );
+        mOutMemStream = outStreamLoc;
+        *outStream = outStreamLoc.Detach();
+        return S_OK;
+    }
+
+    if ( entry.size == 0 ) { // Nothing to be written.
+        return S_OK;
+    }
+
+    auto outStreamLoc = bit7z::make_com< CFixedBufferOutStream, ISequentialOutStream >(
+        mArena.mData.data() + entry.offset, // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        entry.size
+    );
+    mOutMemStream = outStreamLoc;
+    *outStream = outStreamLoc.Detach();
+    return S_OK;
+}
+
+} // namespace bit7z
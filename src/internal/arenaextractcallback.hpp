@@ -0,0 +1,68 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ARENAEXTRACTCALLBACK_HPP
+#define ARENAEXTRACTCALLBACK_HPP
+
+#include <unordered_map>
+#include <vector>
+
+#include "bitextractionarena.hpp"
+#include "internal/extractcallback.hpp"
+
+namespace bit7z {
+
+class ArenaExtractCallback final : public ExtractCallback {
+    public:
+        ArenaExtractCallback( const BitInputArchive& inputArchive, BitExtractionArena& arena );
+
+        ArenaExtractCallback( const ArenaExtractCallback& ) = delete;
+
+        ArenaExtractCallback( ArenaExtractCallback&& ) = delete;
+
+        auto operator=( const ArenaExtractCallback& ) -> ArenaExtractCallback& = delete;
+
+        auto operator=( ArenaExtractCallback&& ) -> ArenaExtractCallback& = delete;
+
+        ~ArenaExtractCallback() override = default;
+
+        /**
+         * @brief Creates the arena's entries of the given items (or of all the archive's items, if no index
+         *        is given), and allocates the arena's data buffer with the total size of the items.
+         *
+         * @note The folders are ignored.
+         *
+         * @return the (sorted) indices of the items to be extracted.
+         */
+        auto prepareArena( const std::vector< uint32_t >& indices ) -> std::vector< uint32_t >;
+
+    private:
+        BitExtractionArena& mArena;
+        std::unordered_map< uint32_t, std::size_t > mEntryPositions;
+
+        // Whether the size of each entry was known before the extraction (and hence its space was allocated).
+        std::vector< bool > mIsEntrySized;
+
+        // The items whose size is not known in advance are buffered, and then appended to the arena.
+        buffer_t mPendingBuffer;
+        std::size_t mPendingEntry;
+        bool mHasPendingEntry;
+
+        CMyComPtr< ISequentialOutStream > mOutMemStream;
+
+        auto finishOperation( OperationResult operationResult ) -> HRESULT override;
+
+        void releaseStream() override;
+
+        auto getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT override;
+};
+
+}  // namespace bit7z
+
+#endif // ARENAEXTRACTCALLBACK_HPP
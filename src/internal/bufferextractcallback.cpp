@@ -36,19 +36,15 @@ auto BufferExtractCallback::getOutStream( uint32_t index, ISequentialOutStream**
     }
 
     // Get Name
-    const BitPropVariant prop = itemProperty( index, BitProperty::Path );
+    const fs::path& itemPath = item( index ).path();
     tstring fullPath;
 
-    if ( prop.isEmpty() ) {
+    if ( itemPath.empty() ) {
         fullPath = kEmptyFileAlias;
-    } else if ( prop.isString() ) {
-        if ( !mHandler.retainDirectories() ) {
-            fullPath = path_to_tstring( fs::path{ prop.getNativeString() }.filename() );
-        } else {
-            fullPath = prop.getString();
-        }
+    } else if ( !mHandler.retainDirectories() ) {
+        fullPath = path_to_tstring( itemPath.filename() );
     } else {
-        return E_FAIL;
+        fullPath = path_to_tstring( itemPath );
     }
 
     if ( mHandler.fileCallback() ) {
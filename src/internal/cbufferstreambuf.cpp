@@ -0,0 +1,50 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/cbufferstreambuf.hpp"
+
+namespace bit7z {
+
+CBufferStreamBuf::CBufferStreamBuf( const buffer_t& buffer ) {
+    // Note: the get area is never written, so casting away the constness is safe.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-type-const-cast)
+    auto* bufferStart = const_cast< char* >( reinterpret_cast< const char* >( buffer.data() ) );
+    setg( bufferStart, bufferStart, bufferStart + buffer.size() ); // NOLINT(*-pro-bounds-pointer-arithmetic)
+}
+
+auto CBufferStreamBuf::seekoff( off_type offset,
+                                std::ios_base::seekdir way,
+                                std::ios_base::openmode which ) -> pos_type {
+    const pos_type invalidPosition{ off_type{ -1 } };
+    if ( ( which & std::ios_base::in ) == 0 ) {
+        return invalidPosition;
+    }
+
+    off_type newPosition = offset;
+    if ( way == std::ios_base::cur ) {
+        newPosition += gptr() - eback();
+    } else if ( way == std::ios_base::end ) {
+        newPosition += egptr() - eback();
+    }
+
+    if ( newPosition < 0 || newPosition > egptr() - eback() ) {
+        return invalidPosition;
+    }
+    setg( eback(), eback() + newPosition, egptr() ); // NOLINT(*-pro-bounds-pointer-arithmetic)
+    return pos_type{ newPosition };
+}
+
+auto CBufferStreamBuf::seekpos( pos_type position, std::ios_base::openmode which ) -> pos_type {
+    return seekoff( off_type{ position }, std::ios_base::beg, which );
+}
+
+} // namespace bit7z
@@ -0,0 +1,34 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CBUFFERSTREAMBUF_HPP
+#define CBUFFERSTREAMBUF_HPP
+
+#include <streambuf>
+
+#include "bittypes.hpp"
+
+namespace bit7z {
+
+/* A read-only and seekable std::streambuf over the content of a buffer (which must outlive it). */
+class CBufferStreamBuf final : public std::streambuf {
+    public:
+        explicit CBufferStreamBuf( const buffer_t& buffer );
+
+    protected:
+        auto seekoff( off_type offset,
+                      std::ios_base::seekdir way,
+                      std::ios_base::openmode which ) -> pos_type override;
+
+        auto seekpos( pos_type position, std::ios_base::openmode which ) -> pos_type override;
+};
+
+}  // namespace bit7z
+
+#endif // CBUFFERSTREAMBUF_HPP
@@ -12,14 +12,38 @@
 
 #include <utility>
 
+#ifndef _WIN32
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "bitexception.hpp"
 #include "internal/cfileoutstream.hpp"
+#include "internal/fsutil.hpp"
 #include "internal/stringutil.hpp"
 
 namespace bit7z {
 
+#ifdef _WIN32
 CFileOutStream::CFileOutStream( fs::path filePath, bool createAlways )
     : CStdOutStream( mFileStream ), mFilePath{ std::move( filePath ) } {
+#else
+CFileOutStream::CFileOutStream( fs::path filePath, bool createAlways )
+    : mFilePath{ std::move( filePath ) },
+      mFileDescriptor{ -1 },
+      mFailed{ false },
+      mSparse{ false },
+      mHasTrailingHole{ false },
+      mPosition{ 0 },
+      mMappedData{ nullptr },
+      mMappedSize{ 0 } {
+#endif
     std::error_code error;
     if ( !createAlways && fs::exists( mFilePath, error ) ) {
         if ( !error ) {
@@ -29,6 +53,7 @@ CFileOutStream::CFileOutStream( fs::path filePath, bool createAlways )
         throw BitException( "Failed to create the output file", error, path_to_tstring( mFilePath ) );
     }
 
+#ifdef _WIN32
     /* Disabling std::ofstream's buffering, as unbuffered IO gives better performance
      * with the block sizes read/written by 7-Zip.
      * Note: we need to do this before and after opening the file (https://stackoverflow.com/a/59161297/3497024). */
@@ -46,21 +71,352 @@ CFileOutStream::CFileOutStream( fs::path filePath, bool createAlways )
 #if !defined(_MSC_VER) || _MSC_VER != 1900
     mFileStream.rdbuf()->pubsetbuf( nullptr, 0 );
 #endif
+#else
+    // Same permissions used by std::ofstream (i.e., 0666 & ~umask).
+    constexpr auto kFileMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg, hicpp-signed-bitwise)
+    mFileDescriptor = ::open( mFilePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, kFileMode );
+    if ( mFileDescriptor < 0 ) {
+        throw BitException( "Failed to open the output file", last_error_code(), path_to_tstring( mFilePath ) );
+    }
+#endif
+}
+
+CFileOutStream::~CFileOutStream() {
+#ifndef _WIN32
+    unmapOutput();
+    fillTrailingHole();
+    ::close( mFileDescriptor );
+#endif
 }
 
 auto CFileOutStream::fail() const -> bool {
+#ifdef _WIN32
     return mFileStream.fail();
+#else
+    return mFailed;
+#endif
+}
+
+#ifdef _WIN32
+void CFileOutStream::setSparse( bool /*sparse*/ ) noexcept {}
+
+auto CFileOutStream::mapOutput( uint64_t /*size*/ ) noexcept -> bool {
+    return false;
+}
+#else
+void CFileOutStream::setSparse( bool sparse ) noexcept {
+    mSparse = sparse;
+}
+
+auto CFileOutStream::mapOutput( uint64_t size ) noexcept -> bool {
+#ifdef __linux__
+    if ( mMappedData != nullptr || mSparse || mPosition != 0 || size == 0 ||
+         size > std::numeric_limits< std::size_t >::max() ) {
+        return false;
+    }
+
+    /* The blocks of the file must be actually allocated before mapping it: otherwise, running out of disk space
+     * while the kernel writes back the mapping would result in a SIGBUS rather than in a write error. */
+    int result; // NOLINT(cppcoreguidelines-init-variables)
+    do {
+        result = ::fallocate( mFileDescriptor, 0, 0, static_cast< off_t >( size ) );
+    } while ( result != 0 && errno == EINTR );
+    if ( result != 0 ) {
+        return false;
+    }
+
+    // The file was opened write-only, so we map it via a new read-write descriptor (the mapping outlives it).
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg, hicpp-signed-bitwise)
+    const int mappingDescriptor = ::open( mFilePath.c_str(), O_RDWR | O_CLOEXEC );
+    if ( mappingDescriptor < 0 ) {
+        ::ftruncate( mFileDescriptor, 0 );
+        return false;
+    }
+    void* mappedData = ::mmap( nullptr, static_cast< std::size_t >( size ), PROT_WRITE, MAP_SHARED,
+                               mappingDescriptor, 0 );
+    ::close( mappingDescriptor );
+    if ( mappedData == MAP_FAILED ) { // NOLINT(*-pro-type-cstyle-cast, performance-no-int-to-ptr)
+        ::ftruncate( mFileDescriptor, 0 );
+        return false;
+    }
+    ::madvise( mappedData, static_cast< std::size_t >( size ), MADV_SEQUENTIAL );
+
+    mMappedData = static_cast< unsigned char* >( mappedData );
+    mMappedSize = size;
+    return true;
+#else
+    (void)size;
+    return false;
+#endif
+}
+
+auto CFileOutStream::unmapOutput() noexcept -> bool {
+    if ( mMappedData == nullptr ) {
+        return true;
+    }
+
+    // The written pages are synced before unmapping them, as their write-back errors would be lost otherwise.
+    const bool synced = ::msync( mMappedData, static_cast< std::size_t >( mPosition ), MS_SYNC ) == 0;
+    const bool unmapped = ::munmap( mMappedData, static_cast< std::size_t >( mMappedSize ) ) == 0;
+    // The item may be shorter than its declared size, so the file is truncated to the content actually written.
+    const bool resized = mPosition == mMappedSize ||
+                         ::ftruncate( mFileDescriptor, static_cast< off_t >( mPosition ) ) == 0;
+    // The next writes (if any) go through the descriptor, which must be positioned where the mapped writes ended.
+    const bool positioned = ::lseek( mFileDescriptor, static_cast< off_t >( mPosition ), SEEK_SET ) >= 0;
+    mMappedData = nullptr;
+    mMappedSize = 0;
+    if ( !synced || !unmapped || !resized || !positioned ) {
+        mFailed = true;
+        return false;
+    }
+    return true;
+}
+
+// Size of the blocks checked for being all zeros; it matches the block size of most filesystems.
+constexpr auto kSparseBlockSize = 4096u;
+
+namespace {
+// Converts the errno of the last failed system call to an HRESULT, so that the cause of the failure is kept.
+auto last_error_hresult( unsigned int fallbackError ) noexcept -> HRESULT {
+    const int error = errno;
+    return HRESULT_FROM_WIN32( error > 0 ? static_cast< unsigned int >( error ) : fallbackError );
+}
+
+auto is_zero_block( const unsigned char* data, std::size_t size ) noexcept -> bool {
+    // Comparing the block with itself shifted by one byte lets memcmp use its vectorized implementation.
+    return size > 0 && data[ 0 ] == 0 && std::memcmp( data, data + 1, size - 1 ) == 0;
+}
+} // namespace
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CFileOutStream::Write( const void* data, UInt32 size, UInt32* processedSize ) noexcept {
+    if ( processedSize != nullptr ) {
+        *processedSize = 0;
+    }
+
+    if ( size == 0 ) {
+        return S_OK;
+    }
+
+    const auto* bytes = static_cast< const unsigned char* >( data );
+    if ( mMappedData != nullptr ) {
+        if ( mPosition + size <= mMappedSize ) {
+            std::memcpy( mMappedData + mPosition, bytes, size ); // NOLINT(*-pro-bounds-pointer-arithmetic)
+            mPosition += size;
+            if ( processedSize != nullptr ) {
+                *processedSize = size;
+            }
+            return S_OK;
+        }
+        // The item is longer than its declared size: the remaining content is written normally.
+        if ( !unmapOutput() ) {
+            return last_error_hresult( ERROR_WRITE_FAULT );
+        }
+    }
+
+    if ( mSparse ) {
+        const HRESULT result = writeSparse( bytes, size );
+        if ( result == S_OK && processedSize != nullptr ) {
+            *processedSize = size;
+        }
+        return result;
+    }
+
+    ssize_t writtenSize; // NOLINT(cppcoreguidelines-init-variables)
+    do {
+        writtenSize = ::write( mFileDescriptor, bytes, size );
+    } while ( writtenSize < 0 && errno == EINTR );
+
+    if ( writtenSize < 0 ) {
+        mFailed = true;
+        return last_error_hresult( ERROR_WRITE_FAULT );
+    }
+
+    mPosition += static_cast< uint64_t >( writtenSize );
+    mHasTrailingHole = false;
+    if ( processedSize != nullptr ) {
+        *processedSize = static_cast< UInt32 >( writtenSize );
+    }
+    return S_OK;
+}
+
+auto CFileOutStream::writeAll( const unsigned char* data, std::size_t size ) noexcept -> HRESULT {
+    while ( size > 0 ) {
+        const ssize_t writtenSize = ::write( mFileDescriptor, data, size );
+        if ( writtenSize < 0 ) {
+            if ( errno == EINTR ) {
+                continue;
+            }
+            mFailed = true;
+            return last_error_hresult( ERROR_WRITE_FAULT );
+        }
+        data += writtenSize; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        size -= static_cast< std::size_t >( writtenSize );
+        mPosition += static_cast< uint64_t >( writtenSize );
+    }
+    mHasTrailingHole = false;
+    return S_OK;
+}
+
+auto CFileOutStream::writeSparse( const unsigned char* data, UInt32 size ) noexcept -> HRESULT {
+    /* The data is split into blocks aligned to the file offsets: consecutive full blocks of zeros are skipped
+     * via a single seek (the file was truncated when opened, so the skipped range is a hole),
+     * while consecutive non-zero (or partial) blocks are written via a single write. */
+    std::size_t offset = 0;
+    while ( offset < size ) {
+        const std::size_t runStart = offset;
+        bool isZeroRun = false;
+        while ( offset < size ) {
+            const auto blockStart = static_cast< std::size_t >( ( mPosition + offset - runStart ) % kSparseBlockSize );
+            const std::size_t blockSize = std::min< std::size_t >( size - offset, kSparseBlockSize - blockStart );
+            const bool isZeroBlock = blockSize == kSparseBlockSize && is_zero_block( data + offset, blockSize );
+            if ( offset == runStart ) {
+                isZeroRun = isZeroBlock;
+            } else if ( isZeroBlock != isZeroRun ) {
+                break;
+            }
+            offset += blockSize;
+        }
+
+        const std::size_t runSize = offset - runStart;
+        if ( !isZeroRun ) {
+            const HRESULT result = writeAll( data + runStart, runSize );
+            if ( result != S_OK ) {
+                return result;
+            }
+            continue;
+        }
+
+        if ( ::lseek( mFileDescriptor, static_cast< off_t >( runSize ), SEEK_CUR ) < 0 ) {
+            mFailed = true;
+            return last_error_hresult( ERROR_SEEK );
+        }
+        mPosition += runSize;
+        mHasTrailingHole = true;
+    }
+    return S_OK;
+}
+
+auto CFileOutStream::fillTrailingHole() noexcept -> bool {
+    if ( !mHasTrailingHole ) {
+        return true;
+    }
+    mHasTrailingHole = false;
+
+    // Skipping the final zeros of the file doesn't extend it, so we need to set its final size explicitly.
+    struct stat fileStat{};
+    if ( ::fstat( mFileDescriptor, &fileStat ) != 0 ) {
+        return false;
+    }
+    if ( static_cast< uint64_t >( fileStat.st_size ) >= mPosition ) {
+        return true;
+    }
+    return ::ftruncate( mFileDescriptor, static_cast< off_t >( mPosition ) ) == 0;
 }
 
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CFileOutStream::Seek( Int64 offset, UInt32 seekOrigin, UInt64* newPosition ) noexcept {
+    int whence; // NOLINT(cppcoreguidelines-init-variables)
+    switch ( seekOrigin ) {
+        case STREAM_SEEK_SET:
+            whence = SEEK_SET;
+            break;
+        case STREAM_SEEK_CUR:
+            whence = SEEK_CUR;
+            break;
+        case STREAM_SEEK_END:
+            whence = SEEK_END;
+            break;
+        default:
+            return STG_E_INVALIDFUNCTION;
+    }
+
+    if ( !unmapOutput() || !fillTrailingHole() ) {
+        mFailed = true;
+        return last_error_hresult( ERROR_WRITE_FAULT );
+    }
+
+    const off_t position = ::lseek( mFileDescriptor, static_cast< off_t >( offset ), whence );
+    if ( position < 0 ) {
+        return last_error_hresult( ERROR_SEEK );
+    }
+    mPosition = static_cast< uint64_t >( position );
+
+    if ( newPosition != nullptr ) {
+        *newPosition = static_cast< UInt64 >( position );
+    }
+    return S_OK;
+}
+
+auto CFileOutStream::setModifiedTime( FILETIME modifiedTime ) noexcept -> bool {
+    /* Extending the file changes its modified time, so any trailing hole must be filled before;
+     * the same goes for the writes to the mapping of the file, which must be unmapped before. */
+    if ( !unmapOutput() || !fillTrailingHole() ) {
+        mFailed = true;
+    }
+    return filesystem::fsutil::set_file_modified_time( mFileDescriptor, modifiedTime );
+}
+
+auto CFileOutStream::completeWrites() noexcept -> bool {
+    if ( !unmapOutput() || !fillTrailingHole() ) {
+        mFailed = true;
+    }
+    return !mFailed;
+}
+
+auto CFileOutStream::setAttributes( DWORD attributes ) noexcept -> bool {
+    return filesystem::fsutil::set_file_attributes( mFileDescriptor, attributes );
+}
+
+auto CFileOutStream::copyFrom( int fileDescriptor, uint64_t offset, uint64_t size ) noexcept -> bool {
+#ifdef __linux__
+    // Maximum size copied by a single call (the same limit of Linux's read/write system calls).
+    constexpr auto kMaxCopySize = static_cast< uint64_t >( 0x7ffff000 );
+
+    auto inputOffset = static_cast< loff_t >( offset );
+    while ( size > 0 ) {
+        const ssize_t copiedSize = ::copy_file_range( fileDescriptor, &inputOffset, mFileDescriptor, nullptr,
+                                                      static_cast< std::size_t >( std::min( size, kMaxCopySize ) ),
+                                                      0 );
+        if ( copiedSize < 0 && errno == EINTR ) {
+            continue;
+        }
+        if ( copiedSize <= 0 ) { // Either an error, or the input file is shorter than expected.
+            return false;
+        }
+        size -= static_cast< uint64_t >( copiedSize );
+        mPosition += static_cast< uint64_t >( copiedSize );
+    }
+    mHasTrailingHole = false;
+    return true;
+#else
+    (void)fileDescriptor;
+    (void)offset;
+    (void)size;
+    return false;
+#endif
+}
+#endif
+
 COM_DECLSPEC_NOTHROW
 STDMETHODIMP CFileOutStream::SetSize( UInt64 newSize ) noexcept {
+#ifdef _WIN32
     std::error_code error;
     fs::resize_file( mFilePath, newSize, error );
     return error ? E_FAIL : S_OK;
+#else
+    if ( !unmapOutput() ) {
+        return last_error_hresult( ERROR_WRITE_FAULT );
+    }
+    mHasTrailingHole = false;
+    return ::ftruncate( mFileDescriptor, static_cast< off_t >( newSize ) ) == 0 ?
+           S_OK : last_error_hresult( ERROR_WRITE_FAULT );
+#endif
 }
 
 auto CFileOutStream::path() const -> const fs::path& {
     return mFilePath;
 }
 
-} // namespace bit7z
\ No newline at end of file
+} // namespace bit7z
@@ -15,22 +15,108 @@
 #include "bitdefines.hpp"
 #include "internal/cstdoutstream.hpp"
 #include "internal/fs.hpp"
+#include "internal/windows.hpp"
 
 namespace bit7z {
 
+#ifdef _WIN32
 class CFileOutStream : public CStdOutStream {
+#else
+/* On POSIX systems, the file is written through its descriptor, so that the extracted files' metadata
+ * can be applied before closing them, without any further lookup of their paths. */
+class CFileOutStream : public IOutStream, public CMyUnknownImp {
+#endif
     public:
         explicit CFileOutStream( fs::path filePath, bool createAlways = false );
 
+        CFileOutStream( const CFileOutStream& ) = delete;
+
+        CFileOutStream( CFileOutStream&& ) = delete;
+
+        auto operator=( const CFileOutStream& ) -> CFileOutStream& = delete;
+
+        auto operator=( CFileOutStream&& ) -> CFileOutStream& = delete;
+
+        MY_UNKNOWN_VIRTUAL_DESTRUCTOR( ~CFileOutStream() );
+
         BIT7Z_NODISCARD auto path() const -> const fs::path&;
 
         BIT7Z_NODISCARD auto fail() const -> bool;
 
+        /**
+         * Sets whether the blocks containing only zeros must be skipped (leaving holes in the file) rather than written.
+         *
+         * @note Sparse files are supported only on POSIX systems; on Windows, this is a no-op.
+         */
+        void setSparse( bool sparse ) noexcept;
+
+        /**
+         * Pre-allocates the file to the given size and maps it in memory, so that the following writes
+         * are copied directly into the mapping (and written back lazily by the kernel) rather than via write calls.
+         *
+         * Writing past the mapped size, seeking, or resizing the file, falls back to the normal writes;
+         * if the item turns out to be shorter than the mapped size, the file is truncated when closed.
+         * The mapping is written back synchronously when unmapped, so that the write errors are reported by fail().
+         *
+         * @note Memory-mapped output files are supported only on Linux; elsewhere, this is a no-op returning false.
+         *
+         * @return true if the file has been mapped, false if it is written normally.
+         */
+        auto mapOutput( uint64_t size ) noexcept -> bool;
+
         BIT7Z_STDMETHOD( SetSize, UInt64 newSize );
 
+#ifndef _WIN32
+        // IOutStream
+        BIT7Z_STDMETHOD( Write, void const* data, UInt32 size, UInt32* processedSize );
+
+        BIT7Z_STDMETHOD( Seek, Int64 offset, UInt32 seekOrigin, UInt64* newPosition );
+
+        auto setModifiedTime( FILETIME modifiedTime ) noexcept -> bool;
+
+        /**
+         * Completes the pending writes of the file, i.e., it writes back and unmaps the mapping of the file (if any),
+         * and extends the file over its trailing hole (if any).
+         *
+         * @return false if the file failed to be written (including any previous failed write).
+         */
+        auto completeWrites() noexcept -> bool;
+
+        auto setAttributes( DWORD attributes ) noexcept -> bool;
+
+        /**
+         * Appends to the file the given range of the file opened with the given descriptor,
+         * copying it kernel-side (i.e., via copy_file_range, which can also reflink the data on supporting filesystems).
+         *
+         * @return false if the kernel-side copy is not supported, or it failed.
+         */
+        auto copyFrom( int fileDescriptor, uint64_t offset, uint64_t size ) noexcept -> bool;
+
+        // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
+        MY_UNKNOWN_IMP1( IOutStream ) //-V2507 //-V2511 //-V835
+#endif
+
     private:
         fs::path mFilePath;
+#ifdef _WIN32
         fs::ofstream mFileStream;
+#else
+        int mFileDescriptor;
+        bool mFailed;
+        bool mSparse;
+        bool mHasTrailingHole; // i.e., the file must still be extended up to mPosition.
+        uint64_t mPosition;
+        unsigned char* mMappedData;
+        uint64_t mMappedSize;
+
+        auto writeAll( const unsigned char* data, std::size_t size ) noexcept -> HRESULT;
+
+        auto writeSparse( const unsigned char* data, UInt32 size ) noexcept -> HRESULT;
+
+        auto fillTrailingHole() noexcept -> bool;
+
+        auto unmapOutput() noexcept -> bool;
+#endif
 };
 
 }  // namespace bit7z
@@ -0,0 +1,85 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/cinstreambuf.hpp"
+
+namespace bit7z {
+
+namespace {
+constexpr auto kBufferSize = static_cast< std::size_t >( 64 * 1024 );
+
+inline auto invalid_position() -> std::streambuf::pos_type {
+    return std::streambuf::pos_type{ std::streambuf::off_type{ -1 } };
+}
+} // namespace
+
+CInStreamBuf::CInStreamBuf( IInStream* inStream )
+    : mInStream{ inStream }, mBuffer( kBufferSize ), mStreamPosition{ 0 } {
+    setg( mBuffer.data(), mBuffer.data(), mBuffer.data() );
+}
+
+auto CInStreamBuf::underflow() -> int_type {
+    if ( gptr() < egptr() ) {
+        return traits_type::to_int_type( *gptr() );
+    }
+
+    UInt32 readSize = 0;
+    const HRESULT res = mInStream->Read( mBuffer.data(), static_cast< UInt32 >( mBuffer.size() ), &readSize );
+    if ( res != S_OK || readSize == 0 ) {
+        return traits_type::eof();
+    }
+    mStreamPosition += readSize;
+    setg( mBuffer.data(), mBuffer.data(), mBuffer.data() + readSize ); // NOLINT(*-pro-bounds-pointer-arithmetic)
+    return traits_type::to_int_type( *gptr() );
+}
+
+auto CInStreamBuf::seekoff( off_type offset,
+                            std::ios_base::seekdir way,
+                            std::ios_base::openmode which ) -> pos_type {
+    if ( ( which & std::ios_base::in ) == 0 ) {
+        return invalid_position();
+    }
+
+    if ( way == std::ios_base::end ) {
+        return seekStream( offset, STREAM_SEEK_END );
+    }
+
+    const auto bufferStart = static_cast< int64_t >( mStreamPosition ) - ( egptr() - eback() );
+    const auto currentPosition = static_cast< int64_t >( mStreamPosition ) - ( egptr() - gptr() );
+    const int64_t newPosition = ( way == std::ios_base::cur ? currentPosition : 0 ) + offset;
+    if ( newPosition < 0 ) {
+        return invalid_position();
+    }
+
+    // If the new position is inside the get area, we avoid seeking the stream and reading it again.
+    if ( newPosition >= bufferStart && newPosition <= static_cast< int64_t >( mStreamPosition ) ) {
+        setg( eback(), eback() + ( newPosition - bufferStart ), egptr() ); // NOLINT(*-pro-bounds-pointer-arithmetic)
+        return pos_type{ newPosition };
+    }
+    return seekStream( newPosition, STREAM_SEEK_SET );
+}
+
+auto CInStreamBuf::seekpos( pos_type position, std::ios_base::openmode which ) -> pos_type {
+    return seekoff( off_type{ position }, std::ios_base::beg, which );
+}
+
+auto CInStreamBuf::seekStream( int64_t offset, uint32_t seekOrigin ) -> pos_type {
+    UInt64 newPosition = 0;
+    if ( mInStream->Seek( offset, seekOrigin, &newPosition ) != S_OK ) {
+        return invalid_position();
+    }
+    mStreamPosition = newPosition;
+    setg( mBuffer.data(), mBuffer.data(), mBuffer.data() );
+    return pos_type{ static_cast< off_type >( newPosition ) };
+}
+
+} // namespace bit7z
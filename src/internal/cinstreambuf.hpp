@@ -0,0 +1,47 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CINSTREAMBUF_HPP
+#define CINSTREAMBUF_HPP
+
+#include <cstdint>
+#include <streambuf>
+#include <vector>
+
+#include "internal/com.hpp"
+
+#include <7zip/IStream.h>
+
+namespace bit7z {
+
+/* A read-only and seekable std::streambuf reading from a 7-Zip input stream. */
+class CInStreamBuf final : public std::streambuf {
+    public:
+        explicit CInStreamBuf( IInStream* inStream );
+
+    protected:
+        auto underflow() -> int_type override;
+
+        auto seekoff( off_type offset,
+                      std::ios_base::seekdir way,
+                      std::ios_base::openmode which ) -> pos_type override;
+
+        auto seekpos( pos_type position, std::ios_base::openmode which ) -> pos_type override;
+
+    private:
+        CMyComPtr< IInStream > mInStream;
+        std::vector< char > mBuffer;
+        uint64_t mStreamPosition; // The position of the input stream, i.e., of the end of the get area.
+
+        auto seekStream( int64_t offset, uint32_t seekOrigin ) -> pos_type;
+};
+
+}  // namespace bit7z
+
+#endif // CINSTREAMBUF_HPP
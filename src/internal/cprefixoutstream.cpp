@@ -0,0 +1,57 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+
+#include "internal/cprefixoutstream.hpp"
+
+namespace bit7z {
+
+CPrefixOutStream::CPrefixOutStream( buffer_t& outBuffer, std::size_t maxSize, bool abortWhenFull )
+    : mBuffer( outBuffer ), mMaxSize{ maxSize }, mAbortWhenFull{ abortWhenFull }, mAbortedWhenFull{ false } {}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CPrefixOutStream::Write( const void* data, UInt32 size, UInt32* processedSize ) noexcept {
+    if ( processedSize != nullptr ) {
+        *processedSize = 0;
+    }
+
+    if ( size == 0 ) {
+        return S_OK;
+    }
+
+    const auto* byteData = static_cast< const byte_t* >( data ); //-V2571
+    const std::size_t copySize = std::min( static_cast< std::size_t >( size ), mMaxSize - mBuffer.size() );
+    try {
+        mBuffer.insert( mBuffer.end(), byteData, byteData + copySize ); // NOLINT(*-pro-bounds-pointer-arithmetic)
+    } catch ( ... ) {
+        return E_OUTOFMEMORY;
+    }
+
+    if ( mAbortWhenFull && mBuffer.size() == mMaxSize ) {
+        // The rest of the item is not needed, so we stop decoding it.
+        mAbortedWhenFull = true;
+        return E_ABORT;
+    }
+
+    // Note: the data exceeding the maximum size is discarded, but it is reported as written anyway.
+    if ( processedSize != nullptr ) {
+        *processedSize = size;
+    }
+    return S_OK;
+}
+
+auto CPrefixOutStream::abortedWhenFull() const noexcept -> bool {
+    return mAbortedWhenFull;
+}
+
+} // namespace bit7z
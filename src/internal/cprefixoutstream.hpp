@@ -0,0 +1,60 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CPREFIXOUTSTREAM_HPP
+#define CPREFIXOUTSTREAM_HPP
+
+#include <cstddef>
+
+#include "bittypes.hpp"
+#include "internal/com.hpp"
+#include "internal/guids.hpp"
+#include "internal/macros.hpp"
+
+#include <7zip/IStream.h>
+
+namespace bit7z {
+
+/* Keeps only the first bytes of the written data, discarding the rest or aborting the extraction when full. */
+class CPrefixOutStream final : public ISequentialOutStream, public CMyUnknownImp {
+    public:
+        CPrefixOutStream( buffer_t& outBuffer, std::size_t maxSize, bool abortWhenFull );
+
+        CPrefixOutStream( const CPrefixOutStream& ) = delete;
+
+        CPrefixOutStream( CPrefixOutStream&& ) = delete;
+
+        auto operator=( const CPrefixOutStream& ) -> CPrefixOutStream& = delete;
+
+        auto operator=( CPrefixOutStream&& ) -> CPrefixOutStream& = delete;
+
+        MY_UNKNOWN_DESTRUCTOR( ~CPrefixOutStream() ) = default;
+
+        // ISequentialOutStream
+        BIT7Z_STDMETHOD( Write, const void* data, UInt32 size, UInt32* processedSize );
+
+        /**
+         * @return true if the stream aborted the extraction since its buffer was full.
+         */
+        BIT7Z_NODISCARD
+        auto abortedWhenFull() const noexcept -> bool;
+
+        // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
+        MY_UNKNOWN_IMP1( ISequentialOutStream ) //-V2507 //-V2511 //-V835
+
+    private:
+        buffer_t& mBuffer;
+        std::size_t mMaxSize;
+        bool mAbortWhenFull;
+        bool mAbortedWhenFull;
+};
+
+}  // namespace bit7z
+
+#endif // CPREFIXOUTSTREAM_HPP
@@ -0,0 +1,33 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CRC32_HPP
+#define CRC32_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bittypes.hpp"
+
+namespace bit7z {
+
+/**
+ * Updates the given CRC32 (the one used by ZIP and 7z archives) with the given data.
+ *
+ * @param crc   the CRC32 of the data preceding the given one (zero, if there's no preceding data).
+ * @param data  the data.
+ * @param size  the size of the data.
+ *
+ * @return the CRC32 of the whole data.
+ */
+auto crc32_update( uint32_t crc, const byte_t* data, std::size_t size ) noexcept -> uint32_t;
+
+}  // namespace bit7z
+
+#endif //CRC32_HPP
@@ -0,0 +1,55 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CSINKOUTSTREAM_HPP
+#define CSINKOUTSTREAM_HPP
+
+#include <exception>
+
+#include "bititemsink.hpp"
+#include "internal/com.hpp"
+#include "internal/guids.hpp"
+#include "internal/macros.hpp"
+
+#include <7zip/IStream.h>
+
+namespace bit7z {
+
+/* Forwards the written data to a user-provided item sink. */
+class CSinkOutStream final : public ISequentialOutStream, public CMyUnknownImp {
+    public:
+        explicit CSinkOutStream( BitItemSink& sink );
+
+        CSinkOutStream( const CSinkOutStream& ) = delete;
+
+        CSinkOutStream( CSinkOutStream&& ) = delete;
+
+        auto operator=( const CSinkOutStream& ) -> CSinkOutStream& = delete;
+
+        auto operator=( CSinkOutStream&& ) -> CSinkOutStream& = delete;
+
+        MY_UNKNOWN_DESTRUCTOR( ~CSinkOutStream() ) = default;
+
+        // ISequentialOutStream
+        BIT7Z_STDMETHOD( Write, const void* data, UInt32 size, UInt32* processedSize );
+
+        BIT7Z_NODISCARD
+        auto sinkException() const noexcept -> const std::exception_ptr&;
+
+        // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
+        MY_UNKNOWN_IMP1( ISequentialOutStream ) //-V2507 //-V2511 //-V835
+
+    private:
+        BitItemSink& mSink;
+        std::exception_ptr mSinkException;
+};
+
+}  // namespace bit7z
+
+#endif // CSINKOUTSTREAM_HPP
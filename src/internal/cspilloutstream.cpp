@@ -0,0 +1,84 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/cspilloutstream.hpp"
+#include "internal/tempfilebuf.hpp"
+
+namespace bit7z {
+
+CSpillOutStream::CSpillOutStream( BitItemContent& content, SpillPolicy& policy )
+    : mContent( content ), mPolicy( policy ) {}
+
+auto CSpillOutStream::spill() -> bool {
+    try {
+        auto spillFile = std::make_unique< TempFileBuf >( mPolicy.spillDirectory );
+        const auto bufferSize = static_cast< std::streamsize >( mContent.mBuffer.size() );
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto* bufferData = reinterpret_cast< const char* >( mContent.mBuffer.data() );
+        if ( spillFile->sputn( bufferData, bufferSize ) != bufferSize ) {
+            return false;
+        }
+        mContent.mSpillFile = std::move( spillFile );
+    } catch ( ... ) {
+        return false;
+    }
+
+    mPolicy.memoryUsage -= mContent.mBuffer.size();
+    buffer_t{}.swap( mContent.mBuffer ); // Releasing the memory of the buffer.
+    return true;
+}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CSpillOutStream::Write( const void* data, UInt32 size, UInt32* processedSize ) noexcept {
+    if ( processedSize != nullptr ) {
+        *processedSize = 0;
+    }
+
+    if ( size == 0 ) {
+        return S_OK;
+    }
+
+    if ( mContent.isInMemory() ) {
+        const uint64_t newBufferSize = mContent.mBuffer.size() + size;
+        if ( newBufferSize <= mPolicy.itemMemoryThreshold && mPolicy.memoryUsage + size <= mPolicy.memoryBudget ) {
+            const auto* byteData = static_cast< const byte_t* >( data ); //-V2571
+            const auto* byteDataEnd = byteData + size; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            try {
+                mContent.mBuffer.insert( mContent.mBuffer.end(), byteData, byteDataEnd );
+            } catch ( ... ) {
+                return E_OUTOFMEMORY;
+            }
+            mPolicy.memoryUsage += size;
+            mContent.mSize += size;
+            if ( processedSize != nullptr ) {
+                *processedSize = size;
+            }
+            return S_OK;
+        }
+
+        if ( !spill() ) {
+            return HRESULT_FROM_WIN32( ERROR_WRITE_FAULT );
+        }
+    }
+
+    const auto writeSize = static_cast< std::streamsize >( size );
+    if ( mContent.mSpillFile->sputn( static_cast< const char* >( data ), writeSize ) != writeSize ) { //-V2571
+        return HRESULT_FROM_WIN32( ERROR_WRITE_FAULT );
+    }
+    mContent.mSize += size;
+    if ( processedSize != nullptr ) {
+        *processedSize = size;
+    }
+    return S_OK;
+}
+
+} // namespace bit7z
@@ -0,0 +1,66 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CSPILLOUTSTREAM_HPP
+#define CSPILLOUTSTREAM_HPP
+
+#include <cstdint>
+
+#include "bititemcontent.hpp"
+#include "internal/com.hpp"
+#include "internal/fs.hpp"
+#include "internal/guids.hpp"
+#include "internal/macros.hpp"
+
+#include <7zip/IStream.h>
+
+namespace bit7z {
+
+/* The memory limits of an extraction to BitItemContent objects, and the memory used so far. */
+struct SpillPolicy {
+    uint64_t itemMemoryThreshold;
+    uint64_t memoryBudget;
+    fs::path spillDirectory;
+    uint64_t memoryUsage;
+};
+
+/* Writes the content of an item to memory, moving it to a temporary file as soon as it exceeds the memory limits.
+ *
+ * Note: the limits are checked against the data actually written, not against the declared size of the item,
+ * which might be missing or wrong (e.g., in untrusted archives). */
+class CSpillOutStream final : public ISequentialOutStream, public CMyUnknownImp {
+    public:
+        CSpillOutStream( BitItemContent& content, SpillPolicy& policy );
+
+        CSpillOutStream( const CSpillOutStream& ) = delete;
+
+        CSpillOutStream( CSpillOutStream&& ) = delete;
+
+        auto operator=( const CSpillOutStream& ) -> CSpillOutStream& = delete;
+
+        auto operator=( CSpillOutStream&& ) -> CSpillOutStream& = delete;
+
+        MY_UNKNOWN_DESTRUCTOR( ~CSpillOutStream() ) = default;
+
+        // ISequentialOutStream
+        BIT7Z_STDMETHOD( Write, const void* data, UInt32 size, UInt32* processedSize );
+
+        // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
+        MY_UNKNOWN_IMP1( ISequentialOutStream ) //-V2507 //-V2511 //-V835
+
+    private:
+        BitItemContent& mContent;
+        SpillPolicy& mPolicy;
+
+        auto spill() -> bool;
+};
+
+}  // namespace bit7z
+
+#endif // CSPILLOUTSTREAM_HPP
@@ -10,7 +10,9 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 
+#include <algorithm>
 #include <exception>
+#include <limits>
 
 #include "bitexception.hpp"
 #include "internal/extractcallback.hpp"
@@ -19,11 +21,153 @@
 
 namespace bit7z {
 
+namespace {
+constexpr auto kNotPrefetched = std::numeric_limits< uint32_t >::max();
+
+// Maximum number of items whose properties are prefetched in a single pass.
+constexpr auto kPrefetchWindowSize = 1024u;
+
+auto exception_error_code( const std::exception_ptr& exception, HRESULT fallbackResult ) -> std::error_code {
+    try {
+        std::rethrow_exception( exception );
+    } catch ( const BitException& ex ) {
+        return ex.code();
+    } catch ( ... ) {
+        return make_hresult_code( fallbackResult );
+    }
+}
+} // namespace
+
 ExtractCallback::ExtractCallback( const BitInputArchive& inputArchive )
     : Callback( inputArchive.handler() ),
       mInputArchive( inputArchive ),
       mExtractMode( ExtractMode::Extract ),
-      mIsLastItemEncrypted{ false } {}
+      mIsLastItemEncrypted{ false },
+      mContinueOnError{ inputArchive.handler().errorPolicy() == ErrorPolicy::Continue },
+      mCollectedItemErrors{ nullptr },
+      mCurrentIndex{ 0 },
+      mIsItemInProgress{ false },
+      mIsCurrentItemFailed{ false },
+      mIsPrefetchEnabled{ false },
+      mLoadedItemIndex{ kNotPrefetched } {}
+
+void ExtractCallback::collectItemErrors( std::vector< BitItemError >& itemErrors ) noexcept {
+    mContinueOnError = true;
+    mCollectedItemErrors = &itemErrors;
+}
+
+void ExtractCallback::recordItemError( std::error_code error ) {
+    mIsCurrentItemFailed = true;
+    auto& itemErrors = mCollectedItemErrors != nullptr ? *mCollectedItemErrors : mItemErrors;
+    tstring itemPath;
+    try {
+        itemPath = path_to_tstring( item( mCurrentIndex ).path() );
+    } catch ( const BitException& ) {
+        // The item's path could not be loaded (e.g., it is the cause of the item's failure).
+    }
+    itemErrors.push_back( { mCurrentIndex, std::move( itemPath ), error } );
+}
+
+void ExtractCallback::recordFailedItem( uint32_t index, tstring path, const std::exception_ptr& error ) {
+    auto& itemErrors = mCollectedItemErrors != nullptr ? *mCollectedItemErrors : mItemErrors;
+    itemErrors.push_back( { index, std::move( path ), exception_error_code( error, E_FAIL ) } );
+}
+
+auto ExtractCallback::interruptCurrentItem( HRESULT result, uint32_t& index ) -> bool {
+    if ( !mContinueOnError || !mIsItemInProgress ) {
+        return false;
+    }
+
+    releaseStream();
+    mIsItemInProgress = false;
+    if ( !mIsCurrentItemFailed ) {
+        recordItemError( mErrorException ? exception_error_code( mErrorException, result )
+                                         : make_hresult_code( result ) );
+    }
+    mErrorException = nullptr;
+    index = mCurrentIndex;
+    return true;
+}
+
+void ExtractCallback::prefetchItems( const std::vector< uint32_t >& indices ) {
+    mIsPrefetchEnabled = true;
+    mPrefetchIndices = indices;
+    std::sort( mPrefetchIndices.begin(), mPrefetchIndices.end() );
+    mPrefetchedItems.clear(); // A new pass over the items starts from the first one.
+}
+
+auto ExtractCallback::isPrefetchTarget( uint32_t index ) const -> bool {
+    if ( !mIsPrefetchEnabled ) {
+        return false;
+    }
+    return mPrefetchIndices.empty() ? index < mInputArchive.itemsCount()
+                                    : std::binary_search( mPrefetchIndices.cbegin(), mPrefetchIndices.cend(), index );
+}
+
+auto ExtractCallback::findPrefetchedItem( uint32_t index ) const -> const PrefetchedItem* {
+    const auto prefetchedItem = std::lower_bound( mPrefetchedItems.cbegin(), mPrefetchedItems.cend(), index,
+                                                  []( const PrefetchedItem& item, uint32_t itemIndex ) -> bool {
+                                                      return item.index < itemIndex;
+                                                  } );
+    return prefetchedItem != mPrefetchedItems.cend() && prefetchedItem->index == index ? &( *prefetchedItem ) : nullptr;
+}
+
+// Loads the properties of the items to be prefetched starting from the given one (7-Zip requests them in order).
+void ExtractCallback::prefetchWindow( uint32_t index ) {
+    mPrefetchedItems.clear();
+
+    const auto loadItem = [this]( uint32_t itemIndex ) {
+        mPrefetchedItems.push_back( { itemIndex, ProcessedItem{}, nullptr } );
+        try {
+            mPrefetchedItems.back().item.loadItemInfo( mInputArchive, itemIndex );
+        } catch ( const BitException& ) {
+            // The error is thrown only when the item is requested, so that it is attributed only to this item.
+            mPrefetchedItems.back().error = std::current_exception();
+        }
+    };
+
+    if ( mPrefetchIndices.empty() ) {
+        const uint32_t windowSize = std::min( mInputArchive.itemsCount() - index, kPrefetchWindowSize );
+        mPrefetchedItems.reserve( windowSize );
+        for ( uint32_t itemIndex = index; itemIndex < index + windowSize; ++itemIndex ) {
+            loadItem( itemIndex );
+        }
+        return;
+    }
+
+    const auto first = std::lower_bound( mPrefetchIndices.cbegin(), mPrefetchIndices.cend(), index );
+    const auto windowSize = std::min< std::size_t >( mPrefetchIndices.cend() - first, kPrefetchWindowSize );
+    mPrefetchedItems.reserve( windowSize );
+    for ( auto itemIndex = first; itemIndex != first + windowSize; ++itemIndex ) {
+        if ( findPrefetchedItem( *itemIndex ) == nullptr ) { // i.e., the indices might be repeated.
+            loadItem( *itemIndex );
+        }
+    }
+}
+
+auto ExtractCallback::item( uint32_t index ) -> const ProcessedItem& {
+    const auto* prefetchedItem = findPrefetchedItem( index );
+    // Note: the items requested out of order (i.e., before the current window) are loaded one by one.
+    if ( prefetchedItem == nullptr && isPrefetchTarget( index ) &&
+         ( mPrefetchedItems.empty() || index > mPrefetchedItems.back().index ) ) {
+        prefetchWindow( index );
+        prefetchedItem = findPrefetchedItem( index );
+    }
+    if ( prefetchedItem != nullptr ) {
+        if ( prefetchedItem->error != nullptr ) {
+            std::rethrow_exception( prefetchedItem->error );
+        }
+        return prefetchedItem->item;
+    }
+
+    // The item was not prefetched (e.g., the callback is used without calling prefetchItems).
+    if ( mLoadedItemIndex != index ) {
+        mLoadedItemIndex = kNotPrefetched; // In case loadItemInfo throws.
+        mLoadedItem.loadItemInfo( mInputArchive, index );
+        mLoadedItemIndex = index;
+    }
+    return mLoadedItem;
+}
 
 auto ExtractCallback::finishOperation( OperationResult operationResult ) -> HRESULT {
     releaseStream();
@@ -68,9 +212,18 @@ try {
     *outStream = nullptr;
     releaseStream();
 
-    auto isEncrypted = itemProperty( index, BitProperty::Encrypted );
-    if ( isEncrypted.isBool() ) {
-        mIsLastItemEncrypted = isEncrypted.getBool();
+    mCurrentIndex = index;
+    mIsItemInProgress = true;
+    mIsCurrentItemFailed = false;
+    /* The full properties are loaded only for the items to be extracted (or already prefetched); for the other ones
+     * (e.g., the skipped items), a single property is queried, so that their other properties are never loaded. */
+    const auto* prefetchedItem = findPrefetchedItem( index );
+    if ( prefetchedItem != nullptr && prefetchedItem->error == nullptr ) {
+        mIsLastItemEncrypted = prefetchedItem->item.isEncrypted();
+    } else if ( askExtractMode == NArchive::NExtract::NAskMode::kExtract ) {
+        mIsLastItemEncrypted = item( index ).isEncrypted();
+    } else {
+        mIsLastItemEncrypted = mInputArchive.isItemEncrypted( index );
     }
 
     if ( askExtractMode != NArchive::NExtract::NAskMode::kExtract ) {
@@ -79,9 +232,17 @@ try {
 
     return getOutStream( index, outStream );
 } catch ( const BitException& ex ) {
+    if ( mContinueOnError ) { // Without an output stream, 7-Zip skips the item.
+        recordItemError( ex.code() );
+        return S_OK;
+    }
     mErrorException = std::make_exception_ptr( ex );
     return ex.hresultCode();
 } catch ( const std::runtime_error& ) {
+    if ( mContinueOnError ) {
+        recordItemError( make_hresult_code( E_ABORT ) );
+        return S_OK;
+    }
     mErrorException = std::make_exception_ptr(
         BitException( "Failed to get the stream", make_hresult_code( E_ABORT ) ) );
     return E_ABORT;
@@ -110,12 +271,27 @@ STDMETHODIMP ExtractCallback::SetOperationResult( Int32 operationResult ) noexce
 
     auto result = map_operation_result( operationResult, mIsLastItemEncrypted );
     if ( result != OperationResult::Success ) {
-        const auto* msg = mExtractMode == ExtractMode::Test ? kTestFailed : kExtractFailed;
         auto error = make_error_code( result );
-        mErrorException = std::make_exception_ptr( BitException( msg, error ) );
+        if ( mContinueOnError ) {
+            if ( !mIsCurrentItemFailed ) {
+                recordItemError( error );
+            }
+        } else {
+            const auto* msg = mExtractMode == ExtractMode::Test ? kTestFailed : kExtractFailed;
+            mErrorException = std::make_exception_ptr( BitException( msg, error ) );
+        }
     }
 
-    return finishOperation( result );
+    const HRESULT finishResult = finishOperation( result );
+    mIsItemInProgress = false;
+    // Note: E_ABORT means that the extraction must be stopped (e.g., a sink threw an exception).
+    if ( mContinueOnError && finishResult != S_OK && finishResult != E_ABORT ) {
+        if ( !mIsCurrentItemFailed ) {
+            recordItemError( make_hresult_code( finishResult ) );
+        }
+        return S_OK;
+    }
+    return finishResult;
 }
 
 COM_DECLSPEC_NOTHROW
@@ -10,12 +10,15 @@
 #ifndef EXTRACTCALLBACK_HPP
 #define EXTRACTCALLBACK_HPP
 
+#include <exception>
 #include <system_error>
+#include <vector>
 
 #include "bitinputarchive.hpp"
 #include "internal/callback.hpp"
 #include "internal/macros.hpp"
 #include "internal/operationresult.hpp"
+#include "internal/processeditem.hpp"
 
 #include <7zip/Archive/IArchive.h>
 #include <7zip/ICoder.h>
@@ -73,6 +76,48 @@ class ExtractCallback : public Callback,
             return mErrorException;
         }
 
+        /**
+         * @brief Makes the callback prefetch the properties needed by the extraction of the given items
+         *        (or of all the archive's items, if no index is given): when one of these items is requested,
+         *        the properties of the next window of items to be extracted are loaded in a single pass.
+         *
+         * @note The items are expected to be requested in order of index: the ones requested out of order
+         *       are loaded one by one.
+         */
+        void prefetchItems( const std::vector< uint32_t >& indices );
+
+        /**
+         * @brief Called after the archive's Extract method completed successfully.
+         */
+        virtual void finishExtraction() {}
+
+        /**
+         * @brief Makes the callback skip the items that fail, appending their errors to the given vector
+         *        rather than to the ones thrown at the end of the extraction.
+         */
+        void collectItemErrors( std::vector< BitItemError >& itemErrors ) noexcept;
+
+        BIT7Z_NODISCARD
+        inline auto continueOnError() const -> bool {
+            return mContinueOnError;
+        }
+
+        /**
+         * @return the errors of the items that failed (and that were not collected by the caller).
+         */
+        BIT7Z_NODISCARD
+        inline auto itemErrors() -> std::vector< BitItemError >& {
+            return mItemErrors;
+        }
+
+        /**
+         * @brief Records the failure of the item being extracted when the archive's Extract method was interrupted
+         *        (e.g., by a write error), so that the extraction can be restarted from the next item.
+         *
+         * @return true if an item was being extracted, and its failure has been recorded.
+         */
+        auto interruptCurrentItem( HRESULT result, uint32_t& index ) -> bool;
+
         // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
         MY_UNKNOWN_IMP3( IArchiveExtractCallback, ICompressProgressInfo, ICryptoGetTextPassword ) //-V2507 //-V2511 //-V835
 
@@ -84,9 +129,25 @@ class ExtractCallback : public Callback,
             return mExtractMode;
         }
 
+        /**
+         * @return the index of the last item whose output stream was requested by 7-Zip.
+         */
+        BIT7Z_NODISCARD
+        inline auto currentIndex() const -> uint32_t {
+            return mCurrentIndex;
+        }
+
+        /**
+         * @return the properties of the item at the given index (prefetched, if possible).
+         *
+         * @throws BitException if the properties of the item could not be loaded.
+         */
+        BIT7Z_NODISCARD
+        auto item( uint32_t index ) -> const ProcessedItem&;
+
         BIT7Z_NODISCARD
-        inline auto isItemFolder( uint32_t index ) const -> bool {
-            return mInputArchive.isItemFolder( index );
+        inline auto isItemFolder( uint32_t index ) -> bool {
+            return item( index ).isDir();
         }
 
         BIT7Z_NODISCARD
@@ -99,6 +160,12 @@ class ExtractCallback : public Callback,
             return mInputArchive;
         }
 
+        /**
+         * @brief Records the failure of the item at the given index, which might not be the current one
+         *        (e.g., the failure of a file written asynchronously), in continue-on-error mode.
+         */
+        void recordFailedItem( uint32_t index, tstring path, const std::exception_ptr& error );
+
         virtual auto finishOperation( OperationResult operationResult ) -> HRESULT;
 
         virtual void releaseStream() = 0;
@@ -106,10 +173,45 @@ class ExtractCallback : public Callback,
         virtual auto getOutStream( UInt32 index, ISequentialOutStream** outStream ) -> HRESULT = 0;
 
     private:
+        struct PrefetchedItem {
+            uint32_t index;
+            ProcessedItem item;
+            std::exception_ptr error; // The error thrown loading the item's properties, if any.
+        };
+
+        void recordItemError( std::error_code error );
+
+        BIT7Z_NODISCARD
+        auto isPrefetchTarget( uint32_t index ) const -> bool;
+
+        BIT7Z_NODISCARD
+        auto findPrefetchedItem( uint32_t index ) const -> const PrefetchedItem*;
+
+        void prefetchWindow( uint32_t index );
+
         const BitInputArchive& mInputArchive;
         ExtractMode mExtractMode;
         bool mIsLastItemEncrypted;
         std::exception_ptr mErrorException;
+
+        // Continue-on-error mode: the failed items are recorded, and the extraction goes on.
+        bool mContinueOnError;
+        std::vector< BitItemError > mItemErrors;
+        std::vector< BitItemError >* mCollectedItemErrors;
+        uint32_t mCurrentIndex;
+        bool mIsItemInProgress;
+        bool mIsCurrentItemFailed;
+
+        // Indices of the items whose properties must be prefetched, sorted (if empty, all the archive's items).
+        bool mIsPrefetchEnabled;
+        std::vector< uint32_t > mPrefetchIndices;
+
+        // Properties of the current window of prefetched items, sorted by index.
+        std::vector< PrefetchedItem > mPrefetchedItems;
+
+        // Properties of the last item that was not prefetched.
+        ProcessedItem mLoadedItem;
+        uint32_t mLoadedItemIndex;
 };
 
 }  // namespace bit7z
@@ -0,0 +1,147 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "bitexception.hpp"
+#include "internal/extractionjournal.hpp"
+#include "internal/stringutil.hpp"
+
+namespace bit7z {
+
+constexpr auto kJournalSignature = "bit7z-extraction-journal";
+
+namespace {
+// A 64-bit FNV-1a hash, which (unlike std::hash) doesn't change between builds, so the journals remain valid.
+class JournalIdHasher final {
+    public:
+        void add( const void* data, std::size_t size ) {
+            const auto* bytes = static_cast< const unsigned char* >( data );
+            for ( std::size_t i = 0; i < size; ++i ) {
+                mHash = ( mHash ^ bytes[ i ] ) * kFnvPrime; // NOLINT(*-pro-bounds-pointer-arithmetic)
+            }
+        }
+
+        void add( const tstring& value ) {
+            add( value.data(), value.size() * sizeof( tchar ) );
+        }
+
+        template< typename T >
+        void add( T value ) {
+            add( &value, sizeof( value ) );
+        }
+
+        BIT7Z_NODISCARD auto hash() const -> uint64_t {
+            return mHash;
+        }
+
+    private:
+        static constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+        uint64_t mHash = 0xcbf29ce484222325ull;
+};
+} // namespace
+
+auto archive_journal_id( const BitInputArchive& inputArchive ) -> uint64_t {
+    JournalIdHasher hasher;
+    const auto& archivePath = inputArchive.archivePath();
+    if ( !archivePath.empty() ) {
+        std::error_code error;
+        const auto absolutePath = fs::absolute( tstring_to_path( archivePath ), error );
+        hasher.add( error ? archivePath : path_to_tstring( absolutePath ) );
+        hasher.add( static_cast< uint64_t >( fs::file_size( tstring_to_path( archivePath ), error ) ) );
+        hasher.add( static_cast< int64_t >(
+            fs::last_write_time( tstring_to_path( archivePath ), error ).time_since_epoch().count() ) );
+        return hasher.hash();
+    }
+
+    // The archive is not a file (e.g., it is in memory, or nested in another archive), so we identify its items.
+    const uint32_t itemsCount = inputArchive.itemsCount();
+    for ( uint32_t index = 0; index < itemsCount; ++index ) {
+        const auto item = inputArchive.itemAt( index );
+        hasher.add( item.path() );
+        hasher.add( item.size() );
+        hasher.add( item.crc() );
+    }
+    return hasher.hash();
+}
+
+ExtractionJournal::ExtractionJournal( fs::path journalPath, uint32_t itemsCount, uint64_t archiveId )
+    : mJournalPath{ std::move( journalPath ) } {
+    bool resumeJournal = false;
+    bool isLastLineTruncated = false;
+    {
+        fs::ifstream journalFile{ mJournalPath };
+        std::string signature;
+        uint32_t journalItemsCount = 0;
+        uint64_t journalArchiveId = 0;
+        if ( journalFile >> signature >> journalItemsCount >> journalArchiveId &&
+             signature == kJournalSignature && journalItemsCount == itemsCount && journalArchiveId == archiveId ) {
+            resumeJournal = true;
+
+            std::string line;
+            std::getline( journalFile, line ); // Skipping the rest of the header line.
+            while ( std::getline( journalFile, line ) ) {
+                if ( journalFile.eof() ) { // The last line was not terminated, i.e., the process was killed writing it.
+                    isLastLineTruncated = !line.empty();
+                    break;
+                }
+
+                std::istringstream lineStream{ line };
+                uint32_t index = 0;
+                uint64_t size = 0;
+                uint32_t crc = 0;
+                if ( lineStream >> index >> size >> crc && index < itemsCount ) {
+                    mCompletedFiles[ index ] = { size, crc };
+                }
+            }
+        }
+    }
+
+    mJournalStream.open( mJournalPath, resumeJournal ? std::ios::app : std::ios::trunc );
+    if ( !mJournalStream.is_open() ) {
+        throw BitException( "Failed to open the extraction journal",
+                            last_error_code(),
+                            path_to_tstring( mJournalPath ) );
+    }
+    if ( !resumeJournal ) {
+        mJournalStream << kJournalSignature << ' ' << itemsCount << ' ' << archiveId << '\n';
+    } else if ( isLastLineTruncated ) { // The new records must not be appended to the truncated one.
+        mJournalStream << '\n';
+    }
+    mJournalStream.flush();
+}
+
+auto ExtractionJournal::completedSize( uint32_t index, uint32_t crc, uint64_t& size ) const -> bool {
+    const auto completedFile = mCompletedFiles.find( index );
+    if ( completedFile == mCompletedFiles.end() || completedFile->second.crc != crc ) {
+        return false;
+    }
+    size = completedFile->second.size;
+    return true;
+}
+
+void ExtractionJournal::recordCompleted( uint32_t index, uint64_t size, uint32_t crc ) {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    mJournalStream << index << ' ' << size << ' ' << crc << '\n';
+    mJournalStream.flush();
+}
+
+void ExtractionJournal::remove() {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    mJournalStream.close();
+    std::error_code error;
+    fs::remove( mJournalPath, error );
+}
+
+} // namespace bit7z
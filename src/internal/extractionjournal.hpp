@@ -0,0 +1,88 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef EXTRACTIONJOURNAL_HPP
+#define EXTRACTIONJOURNAL_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include "bitdefines.hpp"
+#include "bitinputarchive.hpp"
+#include "internal/fs.hpp"
+
+namespace bit7z {
+
+/**
+ * An on-disk journal of the files completely extracted from an archive, allowing an interrupted extraction
+ * to be resumed without extracting them again.
+ *
+ * The journal is a text file starting with a header line (containing the number of items of the archive,
+ * and an identifier of the archive), followed by a line for each completed file, containing its index, size,
+ * and CRC; each line is flushed as soon as its file has been finalized, so the journal survives the termination
+ * of the process.
+ */
+class ExtractionJournal final {
+    public:
+        /**
+         * Opens the journal at the given path, loading the files it records as completed
+         * (if the journal was written for a different archive, i.e., with a different number of items
+         * or identifier, it is started over).
+         */
+        ExtractionJournal( fs::path journalPath, uint32_t itemsCount, uint64_t archiveId );
+
+        ExtractionJournal( const ExtractionJournal& ) = delete;
+
+        ExtractionJournal( ExtractionJournal&& ) = delete;
+
+        auto operator=( const ExtractionJournal& ) -> ExtractionJournal& = delete;
+
+        auto operator=( ExtractionJournal&& ) -> ExtractionJournal& = delete;
+
+        ~ExtractionJournal() = default;
+
+        /**
+         * @return whether the journal records the given file as completed, with the given CRC;
+         *         if so, the recorded size is stored in the given variable.
+         */
+        BIT7Z_NODISCARD auto completedSize( uint32_t index, uint32_t crc, uint64_t& size ) const -> bool;
+
+        /**
+         * Records the given file as completed (this method can be called by multiple threads).
+         */
+        void recordCompleted( uint32_t index, uint64_t size, uint32_t crc );
+
+        /**
+         * Deletes the journal, as the extraction it tracked has been completed.
+         */
+        void remove();
+
+    private:
+        struct CompletedFile {
+            uint64_t size;
+            uint32_t crc;
+        };
+
+        fs::path mJournalPath;
+        std::unordered_map< uint32_t, CompletedFile > mCompletedFiles;
+        fs::ofstream mJournalStream;
+        std::mutex mMutex;
+};
+
+/**
+ * @return an identifier of the given archive for its extraction journal: for archive files, a hash of their path,
+ *         size, and modified time; for the other archives (e.g., in memory), a hash of their items' paths, sizes,
+ *         and CRCs.
+ */
+auto archive_journal_id( const BitInputArchive& inputArchive ) -> uint64_t;
+
+}  // namespace bit7z
+
+#endif // EXTRACTIONJOURNAL_HPP
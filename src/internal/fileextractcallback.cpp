@@ -10,7 +10,12 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+
 #include "bitexception.hpp"
+#include "internal/crc32.hpp"
 #include "internal/fileextractcallback.hpp"
 #include "internal/fsutil.hpp"
 #include "internal/stringutil.hpp"
@@ -21,18 +26,193 @@ using namespace NWindows;
 
 namespace bit7z {
 
+constexpr auto kCannotDeleteOutput = "Cannot delete output file";
+
+namespace {
+/**
+ * Prepares the output path of an extracted file, handling the case in which the file already exists.
+ *
+ * @return true if the file must be extracted, false if it must be skipped.
+ */
+auto prepare_output_file( const fs::path& filePath, OverwriteMode overwriteMode ) -> bool {
+    std::error_code error;
+    fs::create_directories( filePath.parent_path(), error );
+
+    if ( fs::exists( filePath, error ) ) {
+        switch ( overwriteMode ) {
+            case OverwriteMode::None: {
+                throw BitException( kCannotDeleteOutput, make_hresult_code( E_ABORT ), path_to_tstring( filePath ) );
+            }
+            case OverwriteMode::Skip: {
+                return false;
+            }
+            case OverwriteMode::Overwrite:
+            default: {
+                if ( !fs::remove( filePath, error ) ) {
+                    throw BitException( kCannotDeleteOutput,
+                                        make_hresult_code( E_ABORT ),
+                                        path_to_tstring( filePath ) );
+                }
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+/* Applies the item's metadata to the extracted file, releasing the stream of the file.
+ * Returns false if the file failed to be written, including while completing its writes (e.g., its mapping). */
+auto apply_file_metadata( CMyComPtr< CFileOutStream >& fileOutStream, const ProcessedItem& item ) -> bool {
+    const fs::path filePath = fileOutStream->path();
+#ifdef _WIN32
+    const bool isWritten = !fileOutStream->fail();
+    fileOutStream.Release(); // We need to release the file to change its modified time!
+
+    const auto creationTime = item.hasCreationTime() ? item.creationTime() : FILETIME{};
+    const auto accessTime = item.hasAccessTime() ? item.accessTime() : FILETIME{};
+    const auto modifiedTime = item.hasModifiedTime() ? item.modifiedTime() : FILETIME{};
+    filesystem::fsutil::set_file_time( filePath, creationTime, accessTime, modifiedTime );
+
+    if ( item.areAttributesDefined() ) {
+        filesystem::fsutil::set_file_attributes( filePath, item.attributes() );
+    }
+    return isWritten;
+#else
+    // The file is still open, so we can set its metadata via its descriptor, without walking its path again.
+    if ( item.hasModifiedTime() ) {
+        fileOutStream->setModifiedTime( item.modifiedTime() );
+    }
+
+    // Setting the modified time already completed the writes; otherwise, they are completed (and checked) here.
+    const bool isWritten = fileOutStream->completeWrites();
+
+    const bool restoreAttributesByPath = item.areAttributesDefined() &&
+                                         !fileOutStream->setAttributes( item.attributes() );
+    fileOutStream.Release();
+
+    if ( restoreAttributesByPath ) { // e.g., symbolic links, which must replace the extracted file.
+        filesystem::fsutil::set_file_attributes( filePath, item.attributes() );
+    }
+    return isWritten;
+#endif
+}
+
+auto filetime_seconds( FILETIME fileTime ) -> uint64_t {
+    constexpr auto kFileTimeTicksPerSecond = 10000000ull;
+    return ( ( static_cast< uint64_t >( fileTime.dwHighDateTime ) << 32u ) + fileTime.dwLowDateTime ) /
+           kFileTimeTicksPerSecond;
+}
+
+// Computes the CRC32 (the one used by ZIP and 7z archives) of the content of the given file.
+auto file_crc32( const fs::path& filePath, uint32_t& crc ) -> bool {
+    fs::ifstream inputFile{ filePath, std::ios::binary };
+    if ( !inputFile.is_open() ) {
+        return false;
+    }
+
+    constexpr auto kBufferSize = 64u * 1024u;
+    std::vector< char > buffer( kBufferSize );
+    uint32_t value = 0;
+    while ( inputFile ) {
+        inputFile.read( buffer.data(), static_cast< std::streamsize >( buffer.size() ) );
+        const auto readSize = static_cast< std::size_t >( inputFile.gcount() );
+        // NOLINTNEXTLINE(*-pro-type-reinterpret-cast)
+        value = crc32_update( value, reinterpret_cast< const byte_t* >( buffer.data() ), readSize );
+    }
+    if ( inputFile.bad() ) {
+        return false;
+    }
+    crc = value;
+    return true;
+}
+
+// Records the given extracted file as completed in the extraction journal (if any).
+void record_completed_file( ExtractionJournal* journal,
+                            uint32_t index,
+                            const fs::path& filePath,
+                            const ProcessedItem& item ) {
+    if ( journal == nullptr ) {
+        return;
+    }
+    std::error_code error;
+    const auto fileSize = fs::file_size( filePath, error );
+    if ( !error ) {
+        journal->recordCompleted( index, fileSize, item.hasCrc() ? item.crc() : 0 );
+    }
+}
+
+/* Writes the buffered content of an extracted item to the given file (used by the writer pool's threads).
+ * Returns false if the file has been skipped. */
+auto write_output_file( const fs::path& filePath,
+                        OverwriteMode overwriteMode,
+                        bool sparse,
+                        const ProcessedItem& item,
+                        const buffer_t& content ) -> bool {
+    if ( !prepare_output_file( filePath, overwriteMode ) ) {
+        return false;
+    }
+
+    auto fileOutStream = bit7z::make_com< CFileOutStream >( filePath, true );
+    fileOutStream->setSparse( sparse );
+    const byte_t* data = content.data();
+    std::size_t remainingSize = content.size();
+    while ( remainingSize > 0 ) {
+        const auto chunkSize = static_cast< UInt32 >(
+            std::min< std::size_t >( remainingSize, std::numeric_limits< UInt32 >::max() ) );
+        UInt32 writtenSize = 0;
+        const HRESULT result = fileOutStream->Write( data, chunkSize, &writtenSize );
+        if ( result != S_OK || writtenSize == 0 ) {
+            throw BitException( "Failed to write the output file",
+                                make_hresult_code( result != S_OK ? result : E_FAIL ),
+                                path_to_tstring( filePath ) );
+        }
+        data += writtenSize; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        remainingSize -= writtenSize;
+    }
+    if ( !apply_file_metadata( fileOutStream, item ) ) {
+        throw BitException( "Failed to write the output file",
+                            make_hresult_code( E_FAIL ),
+                            path_to_tstring( filePath ) );
+    }
+    return true;
+}
+} // namespace
+
 FileExtractCallback::FileExtractCallback( const BitInputArchive& inputArchive, const tstring& directoryPath )
     : ExtractCallback( inputArchive ),
-      mInFilePath( tstring_to_path( inputArchive.archivePath() ) ),
+      mInFilePath( tstring_to_path( inputArchive.archiveName() ) ),
       mDirectoryPath( tstring_to_path( directoryPath ) ),
-      mRetainDirectories( inputArchive.handler().retainDirectories() ) {}
+      mRetainDirectories( inputArchive.handler().retainDirectories() ),
+      mCurrentItem( nullptr ),
+      mStoredItemCopier( inputArchive ) {
+    const auto journalPath = inputArchive.handler().extractionJournal();
+    if ( !journalPath.empty() ) {
+        mJournal = std::make_unique< ExtractionJournal >( tstring_to_path( journalPath ),
+                                                          inputArchive.itemsCount(),
+                                                          archive_journal_id( inputArchive ) );
+    }
+}
 
 void FileExtractCallback::releaseStream() {
     mFileOutStream.Release(); // We need to release the file to change its modified time!
+    if ( mBufferOutStream != nullptr ) { // The buffer of the item was not submitted (e.g., the item was aborted).
+        mBufferOutStream.Release();
+        releasePendingBuffer();
+    }
 }
 
 auto FileExtractCallback::finishOperation( OperationResult operationResult ) -> HRESULT {
     const HRESULT result = operationResult != OperationResult::Success ? E_FAIL : S_OK;
+    if ( mBufferOutStream != nullptr ) {
+        mBufferOutStream.Release();
+        if ( extractMode() == ExtractMode::Extract ) {
+            submitPendingBuffer( operationResult );
+        } else {
+            releasePendingBuffer();
+        }
+        return result;
+    }
+
     if ( mFileOutStream == nullptr ) {
         return result;
     }
@@ -41,31 +221,94 @@ auto FileExtractCallback::finishOperation( OperationResult operationResult ) ->
         return E_FAIL;
     }
 
-    mFileOutStream.Release(); // We need to release the file to change its modified time!
-
     if ( extractMode() != ExtractMode::Extract ) { // No need to set attributes or modified time of the file.
+        mFileOutStream.Release();
         return result;
     }
 
+    // Writing back a memory-mapped file can fail only here, so the file is checked again before journaling it.
+    if ( !apply_file_metadata( mFileOutStream, *mCurrentItem ) ) {
+        return E_FAIL;
+    }
+    if ( result == S_OK ) {
+        record_completed_file( mJournal.get(), currentIndex(), mFilePathOnDisk, *mCurrentItem );
+    }
+    return result;
+}
+
+void FileExtractCallback::finishExtraction() {
+    waitWriterPool();
+
+    /* Extracting the content of a directory changes its modified time,
+     * so we restore the directories' times only at the end of the extraction. */
+    for ( const auto& directory : mExtractedDirectories ) {
 #ifdef _WIN32
-    const auto creationTime = mCurrentItem.hasCreationTime() ? mCurrentItem.creationTime() : FILETIME{};
-    const auto accessTime = mCurrentItem.hasAccessTime() ? mCurrentItem.accessTime() : FILETIME{};
-    const auto modifiedTime = mCurrentItem.hasModifiedTime() ? mCurrentItem.modifiedTime() : FILETIME{};
-    filesystem::fsutil::set_file_time( mFilePathOnDisk, creationTime, accessTime, modifiedTime );
+        filesystem::fsutil::set_file_time( directory.path, FILETIME{}, FILETIME{}, directory.modifiedTime );
 #else
-    if ( mCurrentItem.hasModifiedTime() ) {
-        filesystem::fsutil::set_file_modified_time( mFilePathOnDisk, mCurrentItem.modifiedTime() );
-    }
+        filesystem::fsutil::set_file_modified_time( directory.path, directory.modifiedTime );
 #endif
+    }
+    mExtractedDirectories.clear();
+}
 
-    if ( mCurrentItem.areAttributesDefined() ) {
-        filesystem::fsutil::set_file_attributes( mFilePathOnDisk, mCurrentItem.attributes() );
+auto FileExtractCallback::shouldUseWriterPool() const -> bool {
+    if ( mHandler.writerThreads() == 0 ) {
+        return false;
     }
-    return result;
+    // Only the items whose size is known in advance and fits the memory limit are written by the pool.
+    return mCurrentItem->hasSize() && mCurrentItem->size() <= mHandler.writerMemoryLimit();
+}
+
+void FileExtractCallback::waitWriterPool() {
+    if ( mWriterPool == nullptr ) {
+        return;
+    }
+    mPooledPathHashes.clear();
+    if ( continueOnError() ) {
+        mWriterPool->wait();
+        reportFailedWrites();
+    } else {
+        mWriterPool->finish();
+    }
+}
+
+void FileExtractCallback::reportFailedWrites() {
+    if ( !continueOnError() ) {
+        mWriterPool->rethrowIfFailed();
+        return;
+    }
+    // The failed files are reported as the errors of their own items, not of the item currently extracted.
+    for ( auto& failedWrite : mWriterPool->takeFailedWrites() ) {
+        recordFailedItem( failedWrite.itemIndex, std::move( failedWrite.itemPath ), failedWrite.error );
+    }
+}
+
+void FileExtractCallback::submitPendingBuffer( OperationResult operationResult ) {
+    mWriterPool->submit( std::move( mPendingBuffer ),
+                         currentIndex(),
+                         path_to_tstring( mCurrentItem->path() ),
+                         [ filePath = mFilePathOnDisk,
+                           overwriteMode = mHandler.overwriteMode(),
+                           sparse = mHandler.sparseExtraction(),
+                           item = *mCurrentItem,
+                           index = currentIndex(),
+                           journal = mJournal.get(),
+                           // A file with invalid content (e.g., due to a CRC error) is written, but not completed.
+                           isValid = operationResult == OperationResult::Success ]( const buffer_t& content ) {
+                             if ( write_output_file( filePath, overwriteMode, sparse, item, content ) && isValid ) {
+                                 record_completed_file( journal, index, filePath, item );
+                             }
+                         } );
+    mPendingBuffer = buffer_t{};
+}
+
+void FileExtractCallback::releasePendingBuffer() {
+    mWriterPool->releaseBuffer( std::move( mPendingBuffer ) );
+    mPendingBuffer = buffer_t{};
 }
 
 auto FileExtractCallback::getCurrentItemPath() const -> fs::path {
-    fs::path filePath = mCurrentItem.path();
+    fs::path filePath = mCurrentItem->path();
     if ( filePath.empty() ) {
         filePath = !mInFilePath.empty() ? mInFilePath.stem() : fs::path{ kEmptyFileAlias };
     } else if ( !mRetainDirectories ) {
@@ -76,28 +319,130 @@ auto FileExtractCallback::getCurrentItemPath() const -> fs::path {
     return filePath;
 }
 
-constexpr auto kCannotDeleteOutput = "Cannot delete output file";
-
-auto FileExtractCallback::getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT {
-    mCurrentItem.loadItemInfo( inputArchive(), index );
-
-    auto filePath = getCurrentItemPath();
-    if ( filePath.empty() || ( isItemFolder( index ) && filePath == L"/" ) ) {
-        return S_OK;
-    }
+auto FileExtractCallback::pathOnDisk( const fs::path& filePath ) const -> fs::path {
 #if defined( _WIN32 ) && defined( BIT7Z_PATH_SANITIZATION )
-    mFilePathOnDisk = filesystem::fsutil::sanitized_extraction_path( mDirectoryPath, filePath );
+    fs::path filePathOnDisk = filesystem::fsutil::sanitized_extraction_path( mDirectoryPath, filePath );
 #else
-    mFilePathOnDisk = mDirectoryPath / filePath;
+    fs::path filePathOnDisk = mDirectoryPath / filePath;
 #endif
 
 #if defined( _WIN32 ) && defined( BIT7Z_AUTO_PREFIX_LONG_PATHS )
-    if ( filesystem::fsutil::should_format_long_path( mFilePathOnDisk ) ) {
-        mFilePathOnDisk = filesystem::fsutil::format_long_path( mFilePathOnDisk );
+    if ( filesystem::fsutil::should_format_long_path( filePathOnDisk ) ) {
+        filePathOnDisk = filesystem::fsutil::format_long_path( filePathOnDisk );
     }
 #endif
+    return filePathOnDisk;
+}
+
+auto FileExtractCallback::isCurrentItemUnchanged( const fs::path& filePathOnDisk ) const -> bool {
+    if ( !mCurrentItem->hasSize() || !mCurrentItem->hasModifiedTime() ) {
+        return false;
+    }
+
+    WIN32_FILE_ATTRIBUTE_DATA fileMetadata{};
+    if ( !filesystem::fsutil::get_file_attributes_ex( filePathOnDisk,
+                                                      filesystem::SymlinkPolicy::DoNotFollow,
+                                                      fileMetadata ) ||
+         ( fileMetadata.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) != 0 ) {
+        return false;
+    }
+
+    // Filesystems (and archive formats) store times with different precisions, so we compare them in seconds.
+    if ( filetime_seconds( fileMetadata.ftLastWriteTime ) != filetime_seconds( mCurrentItem->modifiedTime() ) ) {
+        return false;
+    }
+
+    std::error_code error;
+    const auto fileSize = fs::file_size( filePathOnDisk, error );
+    if ( error || fileSize != mCurrentItem->size() ) {
+        return false;
+    }
+
+    if ( mHandler.overwriteMode() != OverwriteMode::SkipIfUnchangedCrc ) {
+        return true;
+    }
+
+    if ( !mCurrentItem->hasCrc() ) { // The archive doesn't provide the CRC of the item, so we cannot check it.
+        return true;
+    }
+
+    uint32_t fileCrc = 0;
+    return file_crc32( filePathOnDisk, fileCrc ) && fileCrc == mCurrentItem->crc();
+}
+
+auto FileExtractCallback::isCurrentItemCompleted( uint32_t index, const fs::path& filePathOnDisk ) const -> bool {
+    uint64_t completedSize = 0;
+    if ( mJournal == nullptr ||
+         !mJournal->completedSize( index, mCurrentItem->hasCrc() ? mCurrentItem->crc() : 0, completedSize ) ) {
+        return false;
+    }
+
+    if ( mCurrentItem->hasSize() && mCurrentItem->size() != completedSize ) {
+        return false;
+    }
+
+    // The output file might have been modified or deleted after the interrupted extraction.
+    std::error_code error;
+    const auto fileSize = fs::file_size( filePathOnDisk, error );
+    return !error && fileSize == completedSize;
+}
+
+auto FileExtractCallback::hasPendingItemsFilter() const -> bool {
+    const OverwriteMode overwriteMode = mHandler.overwriteMode();
+    return mJournal != nullptr ||
+           overwriteMode == OverwriteMode::SkipIfUnchanged ||
+           overwriteMode == OverwriteMode::SkipIfUnchangedCrc;
+}
 
-    if ( !isItemFolder( index ) ) { // File
+auto FileExtractCallback::pendingItems( const std::vector< uint32_t >& indices ) -> std::vector< uint32_t > {
+    const uint32_t itemsCount = indices.empty() ?
+                                inputArchive().itemsCount() : static_cast< uint32_t >( indices.size() );
+    const OverwriteMode overwriteMode = mHandler.overwriteMode();
+    const bool skipUnchanged = overwriteMode == OverwriteMode::SkipIfUnchanged ||
+                               overwriteMode == OverwriteMode::SkipIfUnchangedCrc;
+
+    std::vector< uint32_t > result;
+    result.reserve( itemsCount );
+    for ( uint32_t i = 0; i < itemsCount; ++i ) {
+        const uint32_t index = indices.empty() ? i : indices[ i ];
+        try {
+            mCurrentItem = &item( index );
+        } catch ( const BitException& ) {
+            // The item's properties cannot be loaded: the item is kept, so that its extraction reports the error.
+            result.push_back( index );
+            continue;
+        }
+        if ( !mCurrentItem->isDir() ) {
+            const auto filePath = getCurrentItemPath();
+            if ( !filePath.empty() ) {
+                const auto filePathOnDisk = pathOnDisk( filePath );
+                if ( isCurrentItemCompleted( index, filePathOnDisk ) ||
+                     ( skipUnchanged && isCurrentItemUnchanged( filePathOnDisk ) ) ) {
+                    continue;
+                }
+            }
+        }
+        result.push_back( index );
+    }
+    return result;
+}
+
+void FileExtractCallback::completeJournal() {
+    if ( mJournal != nullptr ) {
+        mJournal->remove();
+    }
+}
+
+auto FileExtractCallback::getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT {
+    mCurrentItem = &item( index );
+
+    auto filePath = getCurrentItemPath();
+    if ( filePath.empty() || ( mCurrentItem->isDir() && filePath == L"/" ) ) {
+        return S_OK;
+    }
+    mFilePathOnDisk = pathOnDisk( filePath );
+
+    if ( !mCurrentItem->isDir() ) { // File
         if ( mHandler.fileCallback() ) {
             // Here we don't use the path_to_tstring function to avoid allocating a string object
             // when using BIT7Z_USE_NATIVE_STRING.
@@ -112,39 +457,67 @@ auto FileExtractCallback::getOutStream( uint32_t index, ISequentialOutStream** o
             mHandler.fileCallback()( filePathString );
         }
 
-        std::error_code error;
-        fs::create_directories( mFilePathOnDisk.parent_path(), error );
+        if ( mWriterPool != nullptr ) {
+            reportFailedWrites();
+        }
 
-        if ( fs::exists( mFilePathOnDisk, error ) ) {
-            const OverwriteMode overwriteMode = mHandler.overwriteMode();
+        if ( shouldUseWriterPool() ) {
+            if ( mWriterPool == nullptr ) {
+                // In continue-on-error mode, a failed write must not cancel the writes of the other files.
+                mWriterPool = std::make_unique< FileWriterPool >( mHandler.writerThreads(),
+                                                                  mHandler.writerMemoryLimit(),
+                                                                  !continueOnError() );
+            }
 
-            switch ( overwriteMode ) {
-                case OverwriteMode::None: {
-                    throw BitException( kCannotDeleteOutput,
-                                        make_hresult_code( E_ABORT ),
-                                        path_to_tstring( mFilePathOnDisk ) );
-                }
-                case OverwriteMode::Skip: {
-                    return S_OK;
-                }
-                case OverwriteMode::Overwrite:
-                default: {
-                    if ( !fs::remove( mFilePathOnDisk, error ) ) {
-                        throw BitException( kCannotDeleteOutput,
-                                            make_hresult_code( E_ABORT ),
-                                            path_to_tstring( mFilePathOnDisk ) );
-                    }
-                    break;
-                }
+            // An archive may contain the same path more than once: its pending writes must not overlap.
+            if ( !mPooledPathHashes.insert( fs::hash_value( mFilePathOnDisk ) ).second ) {
+                waitWriterPool();
+                mPooledPathHashes.insert( fs::hash_value( mFilePathOnDisk ) );
             }
+
+            mPendingBuffer = mWriterPool->acquireBuffer( static_cast< std::size_t >( mCurrentItem->size() ) );
+            auto outStreamLoc = bit7z::make_com< CBufferOutStream >( mPendingBuffer );
+            mBufferOutStream = outStreamLoc;
+            *outStream = outStreamLoc.Detach();
+            return S_OK;
+        }
+
+        // Files written directly must not race with the pending writes of the pool.
+        waitWriterPool();
+
+        if ( !prepare_output_file( mFilePathOnDisk, mHandler.overwriteMode() ) ) {
+            return S_OK;
         }
 
         auto outStreamLoc = bit7z::make_com< CFileOutStream >( mFilePathOnDisk, true );
+        outStreamLoc->setSparse( mHandler.sparseExtraction() );
+
+        /* Fast path: stored items are copied directly from the archive file, and no stream is given to 7-Zip,
+         * so that it skips the item's data (the sparse mode needs to check the data, so it uses the normal path). */
+        if ( !mHandler.sparseExtraction() && mStoredItemCopier.copyItem( index, *mCurrentItem, *outStreamLoc ) ) {
+            if ( !apply_file_metadata( outStreamLoc, *mCurrentItem ) ) {
+                throw BitException( "Failed to write the output file",
+                                    make_hresult_code( E_FAIL ),
+                                    path_to_tstring( mFilePathOnDisk ) );
+            }
+            record_completed_file( mJournal.get(), index, mFilePathOnDisk, *mCurrentItem );
+            return S_OK;
+        }
+
+        // Large items with a known size are written into a memory mapping of their pre-allocated output file.
+        const auto mappedThreshold = mHandler.memoryMappedThreshold();
+        if ( mappedThreshold > 0 && mCurrentItem->hasSize() && mCurrentItem->size() >= mappedThreshold ) {
+            outStreamLoc->mapOutput( mCurrentItem->size() );
+        }
+
         mFileOutStream = outStreamLoc;
         *outStream = outStreamLoc.Detach();
     } else if ( mRetainDirectories ) { // Directory, and we must retain it
         std::error_code error;
         fs::create_directories( mFilePathOnDisk, error );
+        if ( !error && mCurrentItem->hasModifiedTime() ) {
+            mExtractedDirectories.push_back( { mFilePathOnDisk, mCurrentItem->modifiedTime() } );
+        }
     } else {
         // No action needed
     }
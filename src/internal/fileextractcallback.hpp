@@ -10,11 +10,18 @@
 #ifndef FILEEXTRACTCALLBACK_HPP
 #define FILEEXTRACTCALLBACK_HPP
 
+#include <memory>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
+#include "internal/cbufferoutstream.hpp"
 #include "internal/cfileoutstream.hpp"
 #include "internal/extractcallback.hpp"
+#include "internal/extractionjournal.hpp"
+#include "internal/filewriterpool.hpp"
 #include "internal/processeditem.hpp"
+#include "internal/storeditemcopier.hpp"
 
 namespace bit7z {
 
@@ -34,16 +41,59 @@ class FileExtractCallback final : public ExtractCallback {
 
         ~FileExtractCallback() override = default;
 
+        void finishExtraction() override;
+
+        /**
+         * @return whether the items to be extracted must be filtered in advance via pendingItems.
+         */
+        BIT7Z_NODISCARD
+        auto hasPendingItemsFilter() const -> bool;
+
+        /**
+         * @return the indices of the given items (or of all the archive's items, if no index is given)
+         *         excluding the files whose output file exists and is unchanged (OverwriteMode::SkipIfUnchanged),
+         *         and the ones that the extraction journal records as already extracted.
+         */
+        auto pendingItems( const std::vector< uint32_t >& indices ) -> std::vector< uint32_t >;
+
+        /**
+         * @brief Deletes the extraction journal (if any), as the extraction has been completed.
+         */
+        void completeJournal();
+
     private:
-        fs::path mInFilePath;     // Input file path
+        struct ExtractedDirectory {
+            fs::path path;
+            FILETIME modifiedTime;
+        };
+
+        fs::path mInFilePath;     // Input archive name (see BitInputArchive::archiveName())
         fs::path mDirectoryPath;  // Output directory
         fs::path mFilePathOnDisk; // Full path to the file on disk
         bool mRetainDirectories;
 
-        ProcessedItem mCurrentItem;
+        // Properties of the item being extracted (owned by the base ExtractCallback).
+        const ProcessedItem* mCurrentItem;
 
         CMyComPtr< CFileOutStream > mFileOutStream;
 
+        // Copies the items stored without compression directly from the archive file.
+        StoredItemCopier mStoredItemCopier;
+
+        // Journal of the completely extracted files, for resuming an interrupted extraction.
+        std::unique_ptr< ExtractionJournal > mJournal;
+
+        // Pipeline mode: the decoded items are buffered in memory, and written to disk by a pool of threads.
+        std::unique_ptr< FileWriterPool > mWriterPool;
+        CMyComPtr< CBufferOutStream > mBufferOutStream;
+        buffer_t mPendingBuffer;
+
+        // Hashes of the paths of the files submitted to the writer pool and not yet waited for.
+        std::unordered_set< std::size_t > mPooledPathHashes;
+
+        // Directories whose modified time must be restored after all their content has been extracted.
+        std::vector< ExtractedDirectory > mExtractedDirectories;
+
         auto finishOperation( OperationResult operationResult ) -> HRESULT override;
 
         void releaseStream() override;
@@ -51,6 +101,30 @@ class FileExtractCallback final : public ExtractCallback {
         BIT7Z_NODISCARD
         auto getCurrentItemPath() const -> fs::path;
 
+        BIT7Z_NODISCARD
+        auto pathOnDisk( const fs::path& filePath ) const -> fs::path;
+
+        BIT7Z_NODISCARD
+        auto isCurrentItemUnchanged( const fs::path& filePathOnDisk ) const -> bool;
+
+        BIT7Z_NODISCARD
+        auto isCurrentItemCompleted( uint32_t index, const fs::path& filePathOnDisk ) const -> bool;
+
+        BIT7Z_NODISCARD
+        auto shouldUseWriterPool() const -> bool;
+
+        void waitWriterPool();
+
+        /**
+         * Reports the failed writes of the pool: in continue-on-error mode, as the errors of their items;
+         * otherwise, by throwing the error of the first one.
+         */
+        void reportFailedWrites();
+
+        void submitPendingBuffer( OperationResult operationResult );
+
+        void releasePendingBuffer();
+
         auto getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT override;
 };
 
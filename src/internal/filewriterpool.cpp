@@ -0,0 +1,211 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "bitexception.hpp"
+#include "internal/filewriterpool.hpp"
+
+namespace bit7z {
+
+// Maximum number of written buffers kept for being reused.
+constexpr auto kMaxFreeBuffers = 64u;
+
+FileWriterPool::FileWriterPool( uint32_t threadsCount, uint64_t memoryLimit, bool cancelAfterFailure )
+    : mMemoryLimit{ memoryLimit },
+      mCancelAfterFailure{ cancelAfterFailure },
+      mUsedBytes{ 0 },
+      mAcquiredBytes{ 0 },
+      mNextSequence{ 0 },
+      mRunningTasks{ 0 },
+      mStopping{ false } {
+    mWriters.reserve( threadsCount );
+    for ( uint32_t i = 0; i < threadsCount; ++i ) {
+        mWriters.emplace_back( &FileWriterPool::writerLoop, this );
+    }
+}
+
+FileWriterPool::~FileWriterPool() {
+    {
+        const std::lock_guard< std::mutex > lock{ mMutex };
+        mStopping = true;
+    }
+    mWriteAvailable.notify_all();
+    for ( auto& writer : mWriters ) {
+        writer.join();
+    }
+}
+
+auto FileWriterPool::memoryLimit() const noexcept -> uint64_t {
+    return mMemoryLimit;
+}
+
+auto FileWriterPool::acquireBuffer( std::size_t size ) -> buffer_t {
+    std::unique_lock< std::mutex > lock{ mMutex };
+    while ( true ) {
+        const auto freeBuffer = std::find_if( mFreeBuffers.begin(), mFreeBuffers.end(),
+                                              [size]( const buffer_t& buffer ) -> bool {
+                                                  return buffer.capacity() >= size;
+                                              } );
+        if ( freeBuffer != mFreeBuffers.end() ) { // Its capacity is already accounted.
+            buffer_t buffer = std::move( *freeBuffer );
+            mFreeBuffers.erase( freeBuffer );
+            mAcquiredBytes = buffer.capacity();
+            return buffer;
+        }
+
+        // The free buffers are too small to be reused, so we release them if their memory is needed.
+        releaseFreeBuffers( size );
+        // Note: a buffer is always accepted when no memory is used, even if it is bigger than the memory limit.
+        if ( mUsedBytes == 0 || mUsedBytes + size <= mMemoryLimit ) {
+            break;
+        }
+        mWriteCompleted.wait( lock );
+    }
+    mUsedBytes += size;
+    mAcquiredBytes = size;
+    lock.unlock();
+
+    buffer_t buffer;
+    buffer.reserve( size );
+    return buffer;
+}
+
+void FileWriterPool::releaseBuffer( buffer_t buffer ) {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    mUsedBytes = mUsedBytes - mAcquiredBytes + buffer.capacity();
+    mAcquiredBytes = 0;
+    recycleBuffer( std::move( buffer ) );
+    mWriteCompleted.notify_all();
+}
+
+void FileWriterPool::submit( buffer_t buffer, uint32_t itemIndex, tstring itemPath, WriteTask task ) {
+    std::unique_lock< std::mutex > lock{ mMutex };
+    // The buffer might have grown beyond the acquired capacity (e.g., if the item's size was not accurate).
+    mUsedBytes = mUsedBytes - mAcquiredBytes + buffer.capacity();
+    mAcquiredBytes = 0;
+    releaseFreeBuffers( 0 );
+    mPendingWrites.push_back( { mNextSequence++, itemIndex, std::move( itemPath ), std::move( buffer ),
+                                std::move( task ) } );
+    lock.unlock();
+    mWriteAvailable.notify_one();
+}
+
+void FileWriterPool::rethrowIfFailed() {
+    std::unique_lock< std::mutex > lock{ mMutex };
+    if ( mFailedWrites.empty() ) {
+        return;
+    }
+    // Some earlier task might still be running: we wait for it so that the reported error is deterministic.
+    waitPendingWrites( lock );
+    rethrowFirstError();
+}
+
+void FileWriterPool::finish() {
+    std::unique_lock< std::mutex > lock{ mMutex };
+    waitPendingWrites( lock );
+    rethrowFirstError();
+}
+
+void FileWriterPool::wait() {
+    std::unique_lock< std::mutex > lock{ mMutex };
+    waitPendingWrites( lock );
+}
+
+auto FileWriterPool::takeFailedWrites() -> std::vector< FailedWrite > {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    std::vector< FailedWrite > failedWrites;
+    failedWrites.swap( mFailedWrites );
+    return failedWrites;
+}
+
+void FileWriterPool::waitPendingWrites( std::unique_lock< std::mutex >& lock ) {
+    mWriteCompleted.wait( lock, [this]() -> bool {
+        return mPendingWrites.empty() && mRunningTasks == 0;
+    } );
+}
+
+// Keeps the given buffer (whose capacity is already accounted) for being reused, if it fits the memory limit.
+void FileWriterPool::recycleBuffer( buffer_t buffer ) {
+    if ( mFreeBuffers.size() < kMaxFreeBuffers && mUsedBytes <= mMemoryLimit ) {
+        buffer.clear();
+        mFreeBuffers.push_back( std::move( buffer ) );
+    } else {
+        mUsedBytes -= buffer.capacity();
+    }
+}
+
+// Releases the free buffers until the given number of bytes can be used without exceeding the memory limit.
+void FileWriterPool::releaseFreeBuffers( uint64_t requiredBytes ) {
+    while ( !mFreeBuffers.empty() && mUsedBytes + requiredBytes > mMemoryLimit ) {
+        mUsedBytes -= mFreeBuffers.back().capacity();
+        mFreeBuffers.pop_back();
+    }
+}
+
+void FileWriterPool::recordFailure( PendingWrite& pendingWrite, std::exception_ptr error ) {
+    const auto sequence = pendingWrite.sequence;
+    const auto position = std::find_if( mFailedWrites.begin(), mFailedWrites.end(),
+                                        [sequence]( const FailedWrite& failedWrite ) -> bool {
+                                            return failedWrite.sequence > sequence;
+                                        } );
+    mFailedWrites.insert( position, { sequence, pendingWrite.itemIndex, std::move( pendingWrite.itemPath ),
+                                      std::move( error ) } );
+}
+
+void FileWriterPool::rethrowFirstError() const {
+    if ( !mFailedWrites.empty() ) {
+        std::rethrow_exception( mFailedWrites.front().error );
+    }
+}
+
+void FileWriterPool::writerLoop() {
+    std::unique_lock< std::mutex > lock{ mMutex };
+    while ( true ) {
+        mWriteAvailable.wait( lock, [this]() -> bool {
+            return mStopping || !mPendingWrites.empty();
+        } );
+        if ( mPendingWrites.empty() ) { // i.e., mStopping
+            return;
+        }
+
+        PendingWrite pendingWrite = std::move( mPendingWrites.front() );
+        mPendingWrites.pop_front();
+        ++mRunningTasks;
+
+        // Once an error occurred, the following writes are cancelled (if the extraction is going to be aborted).
+        std::exception_ptr error;
+        if ( !mCancelAfterFailure || mFailedWrites.empty() || pendingWrite.sequence < mFailedWrites.front().sequence ) {
+            lock.unlock();
+            try {
+                pendingWrite.task( pendingWrite.buffer );
+            } catch ( ... ) {
+                error = std::current_exception();
+            }
+            lock.lock();
+        } else {
+            error = std::make_exception_ptr( BitException( "The file write was cancelled after a previous failure",
+                                                           make_hresult_code( E_ABORT ) ) );
+        }
+
+        if ( error != nullptr ) {
+            recordFailure( pendingWrite, std::move( error ) );
+        }
+
+        recycleBuffer( std::move( pendingWrite.buffer ) );
+        --mRunningTasks;
+        mWriteCompleted.notify_all();
+    }
+}
+
+} // namespace bit7z
@@ -0,0 +1,148 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef FILEWRITERPOOL_HPP
+#define FILEWRITERPOOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bitdefines.hpp"
+#include "bittypes.hpp"
+
+namespace bit7z {
+
+/**
+ * A pool of threads writing the buffered content of extracted files, decoupling the (possibly slow) creation,
+ * writing, and closing of the output files from the decoding thread.
+ *
+ * The memory used by the buffers (i.e., their capacity) is bounded: acquiring a new buffer blocks the caller until
+ * there's enough room for it. Buffers are recycled once written, so that their allocations can be reused,
+ * as long as they fit the memory limit.
+ *
+ * By default, once a task has failed, the tasks submitted after it are not executed, but they are failed with
+ * a cancellation error; the errors are kept, so that every following call to rethrowIfFailed or finish reports
+ * the first one. Otherwise (i.e., when continuing after the items that fail), every task is executed, and the failed
+ * ones are reported, with the index of their item, by takeFailedWrites.
+ */
+class FileWriterPool final {
+    public:
+        using WriteTask = std::function< void( const buffer_t& ) >;
+
+        struct FailedWrite {
+            uint64_t sequence;
+            uint32_t itemIndex; // The index of the archive's item written by the task.
+            tstring itemPath;   // The path of the archive's item written by the task.
+            std::exception_ptr error;
+        };
+
+        FileWriterPool( uint32_t threadsCount, uint64_t memoryLimit, bool cancelAfterFailure = true );
+
+        FileWriterPool( const FileWriterPool& ) = delete;
+
+        FileWriterPool( FileWriterPool&& ) = delete;
+
+        auto operator=( const FileWriterPool& ) -> FileWriterPool& = delete;
+
+        auto operator=( FileWriterPool&& ) -> FileWriterPool& = delete;
+
+        ~FileWriterPool();
+
+        BIT7Z_NODISCARD auto memoryLimit() const noexcept -> uint64_t;
+
+        /**
+         * Acquires an empty buffer with a capacity of (at least) the given size, possibly reusing the allocation
+         * of an already written one, blocking until there's enough memory for it.
+         *
+         * @note Only one buffer at a time can be acquired: it must be either submitted or released
+         *       before acquiring the next one.
+         */
+        BIT7Z_NODISCARD auto acquireBuffer( std::size_t size ) -> buffer_t;
+
+        /**
+         * Gives back an acquired buffer that is not going to be submitted.
+         */
+        void releaseBuffer( buffer_t buffer );
+
+        /**
+         * Queues the acquired buffer to be written by the given task, writing the given archive's item.
+         */
+        void submit( buffer_t buffer, uint32_t itemIndex, tstring itemPath, WriteTask task );
+
+        /**
+         * If any task has failed, waits for all the pending tasks and throws the error of the first failed one
+         * (in submission order).
+         */
+        void rethrowIfFailed();
+
+        /**
+         * Waits for all the pending tasks and throws the error of the first failed one (in submission order), if any.
+         */
+        void finish();
+
+        /**
+         * Waits for all the pending tasks, without reporting their errors.
+         */
+        void wait();
+
+        /**
+         * @return the failed tasks (in submission order) that were not taken yet, without waiting for the pending ones.
+         */
+        BIT7Z_NODISCARD auto takeFailedWrites() -> std::vector< FailedWrite >;
+
+    private:
+        struct PendingWrite {
+            uint64_t sequence;
+            uint32_t itemIndex;
+            tstring itemPath;
+            buffer_t buffer;
+            WriteTask task;
+        };
+
+        uint64_t mMemoryLimit;
+        bool mCancelAfterFailure;
+        uint64_t mUsedBytes;     // Capacity of all the buffers (acquired, pending, and free).
+        uint64_t mAcquiredBytes; // Capacity accounted for the acquired buffer.
+        uint64_t mNextSequence;
+        std::size_t mRunningTasks;
+        bool mStopping;
+
+        std::deque< PendingWrite > mPendingWrites;
+        std::vector< buffer_t > mFreeBuffers;
+
+        // Failed and cancelled tasks, in submission order.
+        std::vector< FailedWrite > mFailedWrites;
+
+        std::mutex mMutex;
+        std::condition_variable mWriteAvailable;
+        std::condition_variable mWriteCompleted;
+        std::vector< std::thread > mWriters;
+
+        void writerLoop();
+
+        void waitPendingWrites( std::unique_lock< std::mutex >& lock );
+
+        void recycleBuffer( buffer_t buffer );
+
+        void releaseFreeBuffers( uint64_t requiredBytes );
+
+        void recordFailure( PendingWrite& pendingWrite, std::exception_ptr error );
+
+        void rethrowFirstError() const;
+};
+
+}  // namespace bit7z
+
+#endif //FILEWRITERPOOL_HPP
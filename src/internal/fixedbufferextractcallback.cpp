@@ -12,6 +12,7 @@
 
 #include "internal/cfixedbufferoutstream.hpp"
 #include "internal/fixedbufferextractcallback.hpp"
+#include "internal/stringutil.hpp"
 #include "internal/util.hpp"
 
 namespace bit7z {
@@ -31,16 +32,8 @@ auto FixedBufferExtractCallback::getOutStream( uint32_t index, ISequentialOutStr
     }
 
     // Get Name
-    const BitPropVariant prop = itemProperty( index, BitProperty::Path );
-    tstring fullPath;
-
-    if ( prop.isEmpty() ) {
-        fullPath = kEmptyFileAlias;
-    } else if ( prop.isString() ) {
-        fullPath = prop.getString();
-    } else {
-        return E_FAIL;
-    }
+    const fs::path& itemPath = item( index ).path();
+    const tstring fullPath = itemPath.empty() ? tstring{ kEmptyFileAlias } : path_to_tstring( itemPath );
 
     if ( mHandler.fileCallback() ) {
         mHandler.fileCallback()( fullPath );
@@ -22,6 +22,7 @@ using namespace std::filesystem;
 using ifstream = std::ifstream;
 using ofstream = std::ofstream;
 using fstream = std::fstream;
+using filebuf = std::filebuf;
 } // namespace fs
 } // namespace bit7z
 #else
@@ -33,6 +34,7 @@ using namespace ghc::filesystem;
 using ifstream = ghc::filesystem::ifstream;
 using ofstream = ghc::filesystem::ofstream;
 using fstream = ghc::filesystem::fstream;
+using filebuf = ghc::filesystem::filebuf;
 } // namespace fs
 } // namespace bit7z
 #endif
@@ -11,6 +11,7 @@
  */
 
 #include <algorithm> //for std::adjacent_find
+#include <array>
 
 #ifndef _WIN32
 #include <sys/resource.h> // for rlimit, getrlimit, and setrlimit
@@ -184,13 +185,44 @@ static const mode_t global_umask = []() noexcept -> mode_t {
 using stat_t = struct stat;
 const auto os_lstat = &lstat;
 const auto os_stat = &stat;
+const auto os_fstat = &fstat;
 #else
 using stat_t = struct stat64;
 const auto os_lstat = &lstat64;
 const auto os_stat = &stat64;
+const auto os_fstat = &fstat64;
 #endif
 #endif
 
+#ifndef _WIN32
+enum struct ModeUpdate {
+    Apply,
+    Skip,
+    RestoreSymlink
+};
+
+/* Computes the new mode of a file, given its current one and the Win32/POSIX attributes of the extracted item. */
+auto update_file_mode( mode_t& fileMode, DWORD attributes ) noexcept -> ModeUpdate {
+    if ( ( attributes & FILE_ATTRIBUTE_UNIX_EXTENSION ) != 0 ) {
+        fileMode = static_cast< mode_t >( attributes >> 16U );
+        if ( S_ISLNK( fileMode ) ) {
+            return ModeUpdate::RestoreSymlink;
+        }
+
+        if ( S_ISDIR( fileMode ) ) {
+            fileMode |= ( S_IRUSR | S_IWUSR | S_IXUSR );
+        } else if ( !S_ISREG( fileMode ) ) {
+            return ModeUpdate::Skip;
+        }
+    } else if ( S_ISLNK( fileMode ) ) {
+        return ModeUpdate::Skip;
+    } else if ( !S_ISDIR( fileMode ) && ( attributes & FILE_ATTRIBUTE_READONLY ) != 0 ) {
+        fileMode &= static_cast< mode_t >( ~( S_IWUSR | S_IWGRP | S_IWOTH ) );
+    }
+    return ModeUpdate::Apply;
+}
+#endif
+
 auto fsutil::set_file_attributes( const fs::path& filePath, DWORD attributes ) noexcept -> bool {
     if ( filePath.empty() ) {
         return false;
@@ -204,21 +236,14 @@ auto fsutil::set_file_attributes( const fs::path& filePath, DWORD attributes ) n
         return false;
     }
 
-    if ( ( attributes & FILE_ATTRIBUTE_UNIX_EXTENSION ) != 0 ) {
-        fileStat.st_mode = static_cast< mode_t >( attributes >> 16U );
-        if ( S_ISLNK( fileStat.st_mode ) ) {
+    switch ( update_file_mode( fileStat.st_mode, attributes ) ) {
+        case ModeUpdate::RestoreSymlink:
             return restore_symlink( filePath );
-        }
-
-        if ( S_ISDIR( fileStat.st_mode ) ) {
-            fileStat.st_mode |= ( S_IRUSR | S_IWUSR | S_IXUSR );
-        } else if ( !S_ISREG( fileStat.st_mode ) ) {
+        case ModeUpdate::Skip:
             return true;
-        }
-    } else if ( S_ISLNK( fileStat.st_mode ) ) {
-        return true;
-    } else if ( !S_ISDIR( fileStat.st_mode ) && ( attributes & FILE_ATTRIBUTE_READONLY ) != 0 ) {
-        fileStat.st_mode &= static_cast< mode_t >( ~( S_IWUSR | S_IWGRP | S_IWOTH ) );
+        case ModeUpdate::Apply:
+        default:
+            break;
     }
 
     const fs::perms filePermissions = static_cast< fs::perms >( fileStat.st_mode & global_umask ) & fs::perms::mask;
@@ -228,6 +253,29 @@ auto fsutil::set_file_attributes( const fs::path& filePath, DWORD attributes ) n
 #endif
 }
 
+#ifndef _WIN32
+auto fsutil::set_file_attributes( int fileDescriptor, DWORD attributes ) noexcept -> bool {
+    stat_t fileStat{};
+    if ( os_fstat( fileDescriptor, &fileStat ) != 0 ) {
+        return false;
+    }
+
+    switch ( update_file_mode( fileStat.st_mode, attributes ) ) {
+        case ModeUpdate::RestoreSymlink:
+            return false;
+        case ModeUpdate::Skip:
+            return true;
+        case ModeUpdate::Apply:
+        default:
+            break;
+    }
+
+    const auto fileMode = static_cast< mode_t >( fileStat.st_mode & global_umask ) &
+                          static_cast< mode_t >( fs::perms::mask );
+    return fchmod( fileDescriptor, fileMode ) == 0;
+}
+#endif
+
 #ifdef _WIN32
 auto fsutil::set_file_time( const fs::path& filePath,
                             FILETIME creation,
@@ -243,7 +291,7 @@ auto fsutil::set_file_time( const fs::path& filePath,
                                   FILE_SHARE_READ,
                                   nullptr,
                                   OPEN_EXISTING,
-                                  0,
+                                  FILE_FLAG_BACKUP_SEMANTICS, // Needed for setting the times of directories.
                                   nullptr );
     if ( hFile != INVALID_HANDLE_VALUE ) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr)
         res = ::SetFileTime( hFile, &creation, &access, &modified ) != FALSE;
@@ -262,6 +310,12 @@ auto fsutil::set_file_modified_time( const fs::path& filePath, FILETIME ftModifi
     fs::last_write_time( filePath, fileTime, error );
     return !error;
 }
+
+auto fsutil::set_file_modified_time( int fileDescriptor, FILETIME ftModified ) noexcept -> bool {
+    // Note: UTIME_OMIT leaves the access time of the file untouched, as fs::last_write_time does.
+    const std::array< timespec, 2 > fileTimes{ { { 0, UTIME_OMIT }, FILETIME_to_timespec( ftModified ) } };
+    return futimens( fileDescriptor, fileTimes.data() ) == 0;
+}
 #endif
 
 auto fsutil::get_file_attributes_ex( const fs::path& filePath,
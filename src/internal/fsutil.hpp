@@ -43,6 +43,19 @@ BIT7Z_NODISCARD auto get_file_attributes_ex( const fs::path& filePath,
 auto set_file_time( const fs::path& filePath, FILETIME creation, FILETIME access, FILETIME modified ) noexcept -> bool;
 #else
 auto set_file_modified_time( const fs::path& filePath, FILETIME ftModified ) noexcept -> bool;
+
+/**
+ * Sets the modified time of the file opened with the given descriptor (without any further path lookup).
+ */
+auto set_file_modified_time( int fileDescriptor, FILETIME ftModified ) noexcept -> bool;
+
+/**
+ * Sets the attributes of the regular file opened with the given descriptor (without any further path lookup).
+ *
+ * @return false if the attributes could not be applied to the descriptor
+ *         (e.g., the attributes are the ones of a symbolic link, which must be restored through its path).
+ */
+auto set_file_attributes( int fileDescriptor, DWORD attributes ) noexcept -> bool;
 #endif
 
 auto set_file_attributes( const fs::path& filePath, DWORD attributes ) noexcept -> bool;
@@ -0,0 +1,58 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <utility>
+
+#include "internal/cbufferoutstream.hpp"
+#include "internal/multibufferextractcallback.hpp"
+#include "internal/stringutil.hpp"
+#include "internal/util.hpp"
+
+namespace bit7z {
+
+MultiBufferExtractCallback::MultiBufferExtractCallback( const BitInputArchive& inputArchive,
+                                                        std::vector< buffer_t >& outBuffers,
+                                                        std::unordered_map< uint32_t, std::size_t > bufferPositions )
+    : ExtractCallback( inputArchive ),
+      mOutBuffers( outBuffers ),
+      mBufferPositions( std::move( bufferPositions ) ) {}
+
+void MultiBufferExtractCallback::releaseStream() {
+    mOutMemStream.Release();
+}
+
+auto MultiBufferExtractCallback::getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT {
+    const auto bufferPosition = mBufferPositions.find( index );
+    if ( bufferPosition == mBufferPositions.end() ) {
+        return S_OK;
+    }
+
+    const auto& processedItem = item( index );
+    if ( mHandler.fileCallback() ) {
+        const fs::path& itemPath = processedItem.path();
+        mHandler.fileCallback()( itemPath.empty() ? tstring{ kEmptyFileAlias } : path_to_tstring( itemPath ) );
+    }
+
+    auto& outBuffer = mOutBuffers[ bufferPosition->second ];
+    outBuffer.clear();
+    // The buffer is allocated once, with the size of the item (if known, and if it can fit in memory).
+    if ( processedItem.hasSize() && processedItem.size() <= outBuffer.max_size() ) {
+        outBuffer.reserve( static_cast< std::size_t >( processedItem.size() ) );
+    }
+
+    auto outStreamLoc = bit7z::make_com< CBufferOutStream, ISequentialOutStream >( outBuffer );
+    mOutMemStream = outStreamLoc;
+    *outStream = outStreamLoc.Detach();
+    return S_OK;
+}
+
+} // namespace bit7z
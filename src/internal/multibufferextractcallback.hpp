@@ -0,0 +1,50 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef MULTIBUFFEREXTRACTCALLBACK_HPP
+#define MULTIBUFFEREXTRACTCALLBACK_HPP
+
+#include <unordered_map>
+#include <vector>
+
+#include "bittypes.hpp"
+#include "internal/extractcallback.hpp"
+
+namespace bit7z {
+
+/* Extracts each item to its own buffer, given the position of the buffer of each item index. */
+class MultiBufferExtractCallback final : public ExtractCallback {
+    public:
+        MultiBufferExtractCallback( const BitInputArchive& inputArchive,
+                                    std::vector< buffer_t >& outBuffers,
+                                    std::unordered_map< uint32_t, std::size_t > bufferPositions );
+
+        MultiBufferExtractCallback( const MultiBufferExtractCallback& ) = delete;
+
+        MultiBufferExtractCallback( MultiBufferExtractCallback&& ) = delete;
+
+        auto operator=( const MultiBufferExtractCallback& ) -> MultiBufferExtractCallback& = delete;
+
+        auto operator=( MultiBufferExtractCallback&& ) -> MultiBufferExtractCallback& = delete;
+
+        ~MultiBufferExtractCallback() override = default;
+
+    private:
+        std::vector< buffer_t >& mOutBuffers;
+        std::unordered_map< uint32_t, std::size_t > mBufferPositions;
+        CMyComPtr< ISequentialOutStream > mOutMemStream;
+
+        void releaseStream() override;
+
+        auto getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT override;
+};
+
+}  // namespace bit7z
+
+#endif // MULTIBUFFEREXTRACTCALLBACK_HPP
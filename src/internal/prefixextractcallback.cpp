@@ -0,0 +1,74 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+
+#include "internal/prefixextractcallback.hpp"
+#include "internal/stringutil.hpp"
+#include "internal/util.hpp"
+
+namespace bit7z {
+
+PrefixExtractCallback::PrefixExtractCallback( const BitInputArchive& inputArchive,
+                                              std::vector< buffer_t >& outBuffers,
+                                              const std::unordered_map< uint32_t, std::size_t >& bufferPositions,
+                                              std::size_t prefixSize,
+                                              bool abortWhenFull,
+                                              uint32_t lastIndex )
+    : ExtractCallback( inputArchive ),
+      mOutBuffers( outBuffers ),
+      mBufferPositions( bufferPositions ),
+      mPrefixSize{ prefixSize },
+      mAbortWhenFull{ abortWhenFull },
+      mLastIndex{ lastIndex },
+      mCurrentIndex{ lastIndex } {}
+
+auto PrefixExtractCallback::abortedWhenFull() const noexcept -> bool {
+    return mPrefixOutStream != nullptr && mPrefixOutStream->abortedWhenFull();
+}
+
+auto PrefixExtractCallback::currentIndex() const noexcept -> uint32_t {
+    return mCurrentIndex;
+}
+
+void PrefixExtractCallback::releaseStream() {
+    mPrefixOutStream.Release();
+}
+
+auto PrefixExtractCallback::getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT {
+    const auto bufferPosition = mBufferPositions.find( index );
+    if ( bufferPosition == mBufferPositions.end() ) {
+        return S_OK;
+    }
+    mCurrentIndex = index;
+
+    const auto& processedItem = item( index );
+    if ( mHandler.fileCallback() ) {
+        const fs::path& itemPath = processedItem.path();
+        mHandler.fileCallback()( itemPath.empty() ? tstring{ kEmptyFileAlias } : path_to_tstring( itemPath ) );
+    }
+
+    auto& outBuffer = mOutBuffers[ bufferPosition->second ];
+    outBuffer.clear();
+    if ( processedItem.hasSize() ) {
+        outBuffer.reserve( static_cast< std::size_t >( std::min< uint64_t >( processedItem.size(), mPrefixSize ) ) );
+    }
+
+    auto outStreamLoc = bit7z::make_com< CPrefixOutStream >( outBuffer,
+                                                             mPrefixSize,
+                                                             mAbortWhenFull || index == mLastIndex );
+    mPrefixOutStream = outStreamLoc;
+    *outStream = outStreamLoc.Detach();
+    return S_OK;
+}
+
+} // namespace bit7z
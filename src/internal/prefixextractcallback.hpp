@@ -0,0 +1,75 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PREFIXEXTRACTCALLBACK_HPP
+#define PREFIXEXTRACTCALLBACK_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "bittypes.hpp"
+#include "internal/cprefixoutstream.hpp"
+#include "internal/extractcallback.hpp"
+
+namespace bit7z {
+
+/* Extracts the first bytes of each item to its own buffer, given the position of the buffer of each item index.
+ *
+ * When a buffer is full, the extraction is aborted if abortWhenFull is true (so that the caller can resume it
+ * from the next item), or if the item is the last one to be extracted; otherwise, the rest of the item is
+ * decoded and discarded (e.g., in solid archives, where the following items depend on it). */
+class PrefixExtractCallback final : public ExtractCallback {
+    public:
+        PrefixExtractCallback( const BitInputArchive& inputArchive,
+                               std::vector< buffer_t >& outBuffers,
+                               const std::unordered_map< uint32_t, std::size_t >& bufferPositions,
+                               std::size_t prefixSize,
+                               bool abortWhenFull,
+                               uint32_t lastIndex );
+
+        PrefixExtractCallback( const PrefixExtractCallback& ) = delete;
+
+        PrefixExtractCallback( PrefixExtractCallback&& ) = delete;
+
+        auto operator=( const PrefixExtractCallback& ) -> PrefixExtractCallback& = delete;
+
+        auto operator=( PrefixExtractCallback&& ) -> PrefixExtractCallback& = delete;
+
+        ~PrefixExtractCallback() override = default;
+
+        /**
+         * @return true if the extraction was aborted because the prefix of the current item was complete.
+         */
+        BIT7Z_NODISCARD
+        auto abortedWhenFull() const noexcept -> bool;
+
+        /**
+         * @return the index of the last item whose extraction was started.
+         */
+        BIT7Z_NODISCARD
+        auto currentIndex() const noexcept -> uint32_t;
+
+    private:
+        std::vector< buffer_t >& mOutBuffers;
+        const std::unordered_map< uint32_t, std::size_t >& mBufferPositions;
+        std::size_t mPrefixSize;
+        bool mAbortWhenFull;
+        uint32_t mLastIndex;
+        uint32_t mCurrentIndex;
+        CMyComPtr< CPrefixOutStream > mPrefixOutStream;
+
+        void releaseStream() override;
+
+        auto getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT override;
+};
+
+}  // namespace bit7z
+
+#endif // PREFIXEXTRACTCALLBACK_HPP
@@ -16,18 +16,55 @@
 namespace bit7z {
 
 ProcessedItem::ProcessedItem()
-    : mAttributes{ 0 }, mAreAttributesDefined{ false } {}
+    : mSize{ 0 },
+      mCrc{ 0 },
+      mAttributes{ 0 },
+      mAreAttributesDefined{ false },
+      mIsDir{ false },
+      mIsEncrypted{ false },
+      mIsCompressed{ false },
+      mHasSize{ false },
+      mHasCrc{ false } {}
 
 void ProcessedItem::loadItemInfo( const BitInputArchive& inputArchive, std::uint32_t itemIndex ) {
     loadFilePath( inputArchive, itemIndex );
+    loadContentInfo( inputArchive, itemIndex );
     loadAttributes( inputArchive, itemIndex );
     loadTimeMetadata( inputArchive, itemIndex );
 }
 
-auto ProcessedItem::path() const -> fs::path {
+auto ProcessedItem::path() const -> const fs::path& {
     return mFilePath;
 }
 
+auto ProcessedItem::isDir() const -> bool {
+    return mIsDir;
+}
+
+auto ProcessedItem::isEncrypted() const -> bool {
+    return mIsEncrypted;
+}
+
+auto ProcessedItem::isCompressed() const -> bool {
+    return mIsCompressed;
+}
+
+auto ProcessedItem::hasSize() const -> bool {
+    return mHasSize;
+}
+
+auto ProcessedItem::size() const -> uint64_t {
+    return mSize;
+}
+
+auto ProcessedItem::hasCrc() const -> bool {
+    return mHasCrc;
+}
+
+auto ProcessedItem::crc() const -> uint32_t {
+    return mCrc;
+}
+
 auto ProcessedItem::attributes() const -> uint32_t {
     return mAttributes;
 }
@@ -75,6 +112,29 @@ void ProcessedItem::loadFilePath( const BitInputArchive& inputArchive, uint32_t
     }
 }
 
+void ProcessedItem::loadContentInfo( const BitInputArchive& inputArchive, uint32_t itemIndex ) {
+    const BitPropVariant isDir = inputArchive.itemProperty( itemIndex, BitProperty::IsDir );
+    mIsDir = !isDir.isEmpty() && isDir.getBool();
+
+    const BitPropVariant isEncrypted = inputArchive.itemProperty( itemIndex, BitProperty::Encrypted );
+    mIsEncrypted = isEncrypted.isBool() && isEncrypted.getBool();
+
+    // Stored items are reported with the "Store" (e.g., ZIP) or "Copy" (e.g., 7z) method.
+    const BitPropVariant method = inputArchive.itemProperty( itemIndex, BitProperty::Method );
+    const tstring methodName = method.isString() ? method.getString() : tstring{};
+    mIsCompressed = !methodName.empty() &&
+                    methodName != BIT7Z_STRING( "Store" ) &&
+                    methodName != BIT7Z_STRING( "Copy" );
+
+    const BitPropVariant size = inputArchive.itemProperty( itemIndex, BitProperty::Size );
+    mHasSize = !size.isEmpty();
+    mSize = mHasSize ? size.getUInt64() : 0;
+
+    const BitPropVariant crc = inputArchive.itemProperty( itemIndex, BitProperty::CRC );
+    mHasCrc = crc.isUInt32();
+    mCrc = mHasCrc ? crc.getUInt32() : 0;
+}
+
 void ProcessedItem::loadAttributes( const BitInputArchive& inputArchive, uint32_t itemIndex ) {
     mAttributes = 0;
     mAreAttributesDefined = false;
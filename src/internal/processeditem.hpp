@@ -24,7 +24,25 @@ class ProcessedItem final {
 
         void loadItemInfo( const BitInputArchive& inputArchive, std::uint32_t itemIndex );
 
-        BIT7Z_NODISCARD auto path() const -> fs::path;
+        BIT7Z_NODISCARD auto path() const -> const fs::path&;
+
+        BIT7Z_NODISCARD auto isDir() const -> bool;
+
+        BIT7Z_NODISCARD auto isEncrypted() const -> bool;
+
+        /**
+         * @return whether the item's data is compressed, according to its method
+         *         (items without a method, e.g., the TAR ones, are considered uncompressed).
+         */
+        BIT7Z_NODISCARD auto isCompressed() const -> bool;
+
+        BIT7Z_NODISCARD auto hasSize() const -> bool;
+
+        BIT7Z_NODISCARD auto size() const -> uint64_t;
+
+        BIT7Z_NODISCARD auto hasCrc() const -> bool;
+
+        BIT7Z_NODISCARD auto crc() const -> uint32_t;
 
         BIT7Z_NODISCARD auto attributes() const -> uint32_t;
 
@@ -53,11 +71,20 @@ class ProcessedItem final {
         BitPropVariant mAccessTime;
 #endif
 
+        uint64_t mSize;
+        uint32_t mCrc;
         uint32_t mAttributes;
         bool mAreAttributesDefined;
+        bool mIsDir;
+        bool mIsEncrypted;
+        bool mIsCompressed;
+        bool mHasSize;
+        bool mHasCrc;
 
         void loadFilePath( const BitInputArchive& inputArchive, uint32_t itemIndex );
 
+        void loadContentInfo( const BitInputArchive& inputArchive, uint32_t itemIndex );
+
         void loadAttributes( const BitInputArchive& inputArchive, uint32_t itemIndex );
 
         void loadTimeMetadata( const BitInputArchive& inputArchive, uint32_t itemIndex );
@@ -0,0 +1,48 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+
+#include "internal/rangeitemsink.hpp"
+
+namespace bit7z {
+
+RangeItemSink::RangeItemSink( BitItemSink& sink, uint64_t offset, uint64_t length, bool& rangeCompleted ) noexcept
+    : mSink( sink ), mSkipSize{ offset }, mRemainingSize{ length }, mRangeCompleted( rangeCompleted ) {}
+
+auto RangeItemSink::write( const byte_t* data, std::size_t size ) -> bool {
+    if ( mSkipSize >= size ) { // The chunk is entirely before the range.
+        mSkipSize -= size;
+        return true;
+    }
+    data += mSkipSize; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    size -= static_cast< std::size_t >( mSkipSize );
+    mSkipSize = 0;
+
+    const auto rangeSize = static_cast< std::size_t >( std::min< uint64_t >( size, mRemainingSize ) );
+    if ( !mSink.write( data, rangeSize ) ) {
+        return false;
+    }
+    mRemainingSize -= rangeSize;
+    if ( mRemainingSize == 0 ) {
+        mRangeCompleted = true;
+        return false; // Aborting the extraction, as the rest of the item is not needed.
+    }
+    return true;
+}
+
+void RangeItemSink::finish() {
+    // The item ended before the end of the range.
+    mSink.finish();
+}
+
+} // namespace bit7z
@@ -0,0 +1,38 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RANGEITEMSINK_HPP
+#define RANGEITEMSINK_HPP
+
+#include <cstdint>
+
+#include "bititemsink.hpp"
+
+namespace bit7z {
+
+/* Forwards only the given byte range of the decoded content of an item to another sink;
+ * once the range is complete, it requests to abort the extraction, so that the rest of the item is not decoded. */
+class RangeItemSink final : public BitItemSink {
+    public:
+        RangeItemSink( BitItemSink& sink, uint64_t offset, uint64_t length, bool& rangeCompleted ) noexcept;
+
+        auto write( const byte_t* data, std::size_t size ) -> bool override;
+
+        void finish() override;
+
+    private:
+        BitItemSink& mSink;
+        uint64_t mSkipSize;
+        uint64_t mRemainingSize;
+        bool& mRangeCompleted;
+};
+
+}  // namespace bit7z
+
+#endif // RANGEITEMSINK_HPP
@@ -0,0 +1,69 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/sinkextractcallback.hpp"
+#include "internal/util.hpp"
+
+namespace bit7z {
+
+SinkExtractCallback::SinkExtractCallback( const BitInputArchive& inputArchive, const ItemSinkFactory& sinkFactory )
+    : ExtractCallback( inputArchive ),
+      mSinkFactory( sinkFactory ) {}
+
+auto SinkExtractCallback::sinkException() const noexcept -> const std::exception_ptr& {
+    return mSinkException;
+}
+
+void SinkExtractCallback::releaseStream() {
+    if ( mSinkOutStream != nullptr && mSinkOutStream->sinkException() ) {
+        mSinkException = mSinkOutStream->sinkException();
+    }
+    mSinkOutStream.Release();
+    mCurrentSink.reset();
+}
+
+auto SinkExtractCallback::finishOperation( OperationResult operationResult ) -> HRESULT {
+    if ( mCurrentSink != nullptr && operationResult == OperationResult::Success ) {
+        try {
+            mCurrentSink->finish();
+        } catch ( ... ) {
+            mSinkException = std::current_exception();
+            releaseStream();
+            return E_ABORT;
+        }
+    }
+    return ExtractCallback::finishOperation( operationResult );
+}
+
+auto SinkExtractCallback::getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT {
+    if ( isItemFolder( index ) ) {
+        return S_OK;
+    }
+
+    try {
+        mCurrentSink = mSinkFactory( inputArchive().itemAt( index ) );
+    } catch ( ... ) {
+        mSinkException = std::current_exception();
+        return E_ABORT;
+    }
+
+    if ( mCurrentSink == nullptr ) { // The item must be skipped: without an output stream, 7-Zip doesn't write it.
+        return S_OK;
+    }
+
+    auto outStreamLoc = bit7z::make_com< CSinkOutStream >( *mCurrentSink );
+    mSinkOutStream = outStreamLoc;
+    *outStream = outStreamLoc.Detach();
+    return S_OK;
+}
+
+} // namespace bit7z
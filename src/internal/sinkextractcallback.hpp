@@ -0,0 +1,57 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SINKEXTRACTCALLBACK_HPP
+#define SINKEXTRACTCALLBACK_HPP
+
+#include <exception>
+#include <memory>
+
+#include "bititemsink.hpp"
+#include "internal/csinkoutstream.hpp"
+#include "internal/extractcallback.hpp"
+
+namespace bit7z {
+
+class SinkExtractCallback final : public ExtractCallback {
+    public:
+        SinkExtractCallback( const BitInputArchive& inputArchive, const ItemSinkFactory& sinkFactory );
+
+        SinkExtractCallback( const SinkExtractCallback& ) = delete;
+
+        SinkExtractCallback( SinkExtractCallback&& ) = delete;
+
+        auto operator=( const SinkExtractCallback& ) -> SinkExtractCallback& = delete;
+
+        auto operator=( SinkExtractCallback&& ) -> SinkExtractCallback& = delete;
+
+        ~SinkExtractCallback() override = default;
+
+        /**
+         * @return the exception thrown by the user's factory or sinks, if any.
+         */
+        BIT7Z_NODISCARD
+        auto sinkException() const noexcept -> const std::exception_ptr&;
+
+    private:
+        const ItemSinkFactory& mSinkFactory;
+        std::unique_ptr< BitItemSink > mCurrentSink;
+        CMyComPtr< CSinkOutStream > mSinkOutStream;
+        std::exception_ptr mSinkException;
+
+        auto finishOperation( OperationResult operationResult ) -> HRESULT override;
+
+        void releaseStream() override;
+
+        auto getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT override;
+};
+
+}  // namespace bit7z
+
+#endif // SINKEXTRACTCALLBACK_HPP
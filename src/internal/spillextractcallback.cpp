@@ -0,0 +1,77 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <utility>
+
+#include "bitexception.hpp"
+#include "internal/spillextractcallback.hpp"
+#include "internal/stringutil.hpp"
+#include "internal/util.hpp"
+
+namespace bit7z {
+
+SpillExtractCallback::SpillExtractCallback( const BitInputArchive& inputArchive,
+                                            std::map< tstring, BitItemContent >& contentsMap,
+                                            SpillPolicy policy )
+    : ExtractCallback( inputArchive ),
+      mContentsMap( contentsMap ),
+      mPolicy( std::move( policy ) ) {}
+
+void SpillExtractCallback::releaseStream() {
+    mSpillOutStream.Release();
+}
+
+auto SpillExtractCallback::getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT {
+    if ( isItemFolder( index ) ) {
+        return S_OK;
+    }
+
+    const fs::path& itemPath = item( index ).path();
+    tstring fullPath;
+
+    if ( itemPath.empty() ) {
+        fullPath = kEmptyFileAlias;
+    } else if ( !mHandler.retainDirectories() ) {
+        fullPath = path_to_tstring( itemPath.filename() );
+    } else {
+        fullPath = path_to_tstring( itemPath );
+    }
+
+    if ( mHandler.fileCallback() ) {
+        mHandler.fileCallback()( fullPath );
+    }
+
+    auto& outContent = mContentsMap[ fullPath ];
+    if ( outContent.size() > 0 ) {
+        switch ( mHandler.overwriteMode() ) {
+            case OverwriteMode::None: {
+                throw BitException( "Cannot erase output content", make_hresult_code( E_ABORT ) );
+            }
+            case OverwriteMode::Skip: {
+                return S_OK;
+            }
+            case OverwriteMode::Overwrite:
+            default: {
+                mPolicy.memoryUsage -= outContent.buffer().size();
+                outContent = BitItemContent{};
+                break;
+            }
+        }
+    }
+
+    auto outStreamLoc = bit7z::make_com< CSpillOutStream, ISequentialOutStream >( outContent, mPolicy );
+    mSpillOutStream = outStreamLoc;
+    *outStream = outStreamLoc.Detach();
+    return S_OK;
+}
+
+} // namespace bit7z
@@ -0,0 +1,49 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SPILLEXTRACTCALLBACK_HPP
+#define SPILLEXTRACTCALLBACK_HPP
+
+#include <map>
+
+#include "bititemcontent.hpp"
+#include "internal/cspilloutstream.hpp"
+#include "internal/extractcallback.hpp"
+
+namespace bit7z {
+
+class SpillExtractCallback final : public ExtractCallback {
+    public:
+        SpillExtractCallback( const BitInputArchive& inputArchive,
+                              std::map< tstring, BitItemContent >& contentsMap,
+                              SpillPolicy policy );
+
+        SpillExtractCallback( const SpillExtractCallback& ) = delete;
+
+        SpillExtractCallback( SpillExtractCallback&& ) = delete;
+
+        auto operator=( const SpillExtractCallback& ) -> SpillExtractCallback& = delete;
+
+        auto operator=( SpillExtractCallback&& ) -> SpillExtractCallback& = delete;
+
+        ~SpillExtractCallback() override = default;
+
+    private:
+        std::map< tstring, BitItemContent >& mContentsMap;
+        SpillPolicy mPolicy;
+        CMyComPtr< ISequentialOutStream > mSpillOutStream;
+
+        void releaseStream() override;
+
+        auto getOutStream( uint32_t index, ISequentialOutStream** outStream ) -> HRESULT override;
+};
+
+}  // namespace bit7z
+
+#endif // SPILLEXTRACTCALLBACK_HPP
@@ -0,0 +1,258 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/storeditemcopier.hpp"
+
+#ifdef __linux__
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bitexception.hpp"
+#include "bitformat.hpp"
+#include "internal/crc32.hpp"
+#include "internal/operationresult.hpp"
+#include "internal/stringutil.hpp"
+#endif
+
+namespace bit7z {
+
+#ifdef __linux__
+namespace {
+constexpr auto kZipLocalHeaderSize = 30u;
+constexpr auto kZipSignature = 0x04034b50u;
+constexpr auto kZipStoredMethod = 0u;
+constexpr auto kZipEncryptedFlag = 0x0001u;
+constexpr auto kZipDataDescriptorFlag = 0x0008u;
+constexpr auto kZip64SizeMarker = 0xFFFFFFFFu;
+
+constexpr auto kTarBlockSize = 512u;
+
+template< std::size_t N >
+auto read_le( const std::array< unsigned char, N >& buffer, std::size_t offset, std::size_t size ) -> uint64_t {
+    uint64_t value = 0;
+    for ( std::size_t i = size; i > 0; --i ) {
+        value = ( value << 8u ) | buffer[ offset + i - 1 ];
+    }
+    return value;
+}
+
+auto read_exactly( int fileDescriptor, unsigned char* buffer, std::size_t size, uint64_t offset ) -> bool {
+    while ( size > 0 ) {
+        const ssize_t readSize = ::pread( fileDescriptor, buffer, size, static_cast< off_t >( offset ) );
+        if ( readSize < 0 && errno == EINTR ) {
+            continue;
+        }
+        if ( readSize <= 0 ) {
+            return false;
+        }
+        buffer += readSize; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        size -= static_cast< std::size_t >( readSize );
+        offset += static_cast< uint64_t >( readSize );
+    }
+    return true;
+}
+
+// Copies the given range of the file to the output stream, computing its CRC32 from the same read.
+auto copy_with_crc32( int fileDescriptor, uint64_t offset, uint64_t size, CFileOutStream& outStream, uint32_t& crc )
+    -> bool {
+    constexpr auto kBufferSize = 64u * 1024u;
+    std::vector< unsigned char > buffer( kBufferSize );
+    uint32_t value = 0;
+    while ( size > 0 ) {
+        const auto chunkSize = static_cast< UInt32 >( std::min< uint64_t >( size, buffer.size() ) );
+        if ( !read_exactly( fileDescriptor, buffer.data(), chunkSize, offset ) ) {
+            return false;
+        }
+        UInt32 writtenSize = 0;
+        if ( outStream.Write( buffer.data(), chunkSize, &writtenSize ) != S_OK || writtenSize != chunkSize ) {
+            return false;
+        }
+        value = crc32_update( value, buffer.data(), chunkSize );
+        offset += chunkSize;
+        size -= chunkSize;
+    }
+    crc = value;
+    return true;
+}
+
+// Undoes the partial (or invalid) copy of an item to the output stream.
+void clear_output( CFileOutStream& outStream ) {
+    outStream.SetSize( 0 );
+    outStream.Seek( 0, STREAM_SEEK_SET, nullptr );
+}
+
+// Checks the ZIP local file header at the given offset, returning the offset of the item's (stored) data.
+auto zip_data_offset( int fileDescriptor, uint64_t headerOffset, uint64_t itemSize, uint64_t& dataOffset ) -> bool {
+    std::array< unsigned char, kZipLocalHeaderSize > header{};
+    if ( !read_exactly( fileDescriptor, header.data(), header.size(), headerOffset ) ) {
+        return false;
+    }
+
+    const auto flags = read_le( header, 6, 2 );
+    if ( read_le( header, 0, 4 ) != kZipSignature ||
+         read_le( header, 8, 2 ) != kZipStoredMethod ||
+         ( flags & kZipEncryptedFlag ) != 0 ) {
+        return false;
+    }
+
+    // When the data descriptor flag is set, or the item is a ZIP64 one, the sizes are not in the local header.
+    const auto packSize = read_le( header, 18, 4 );
+    const auto unpackSize = read_le( header, 22, 4 );
+    if ( ( flags & kZipDataDescriptorFlag ) == 0 && packSize != kZip64SizeMarker &&
+         ( packSize != itemSize || unpackSize != itemSize ) ) {
+        return false;
+    }
+
+    dataOffset = headerOffset + kZipLocalHeaderSize + read_le( header, 26, 2 ) + read_le( header, 28, 2 );
+    return true;
+}
+
+// Checks the TAR header of a regular file at the given offset, returning the offset of the item's data.
+auto tar_data_offset( int fileDescriptor, uint64_t headerOffset, uint64_t itemSize, uint64_t& dataOffset ) -> bool {
+    std::array< unsigned char, kTarBlockSize > header{};
+    if ( !read_exactly( fileDescriptor, header.data(), header.size(), headerOffset ) ) {
+        return false;
+    }
+
+    constexpr auto kMagicOffset = 257u;
+    constexpr auto kTypeFlagOffset = 156u;
+    constexpr auto kSizeOffset = 124u;
+    constexpr auto kSizeLength = 12u;
+
+    const auto typeFlag = header[ kTypeFlagOffset ];
+    if ( std::memcmp( &header[ kMagicOffset ], "ustar", 5 ) != 0 ||
+         ( typeFlag != '0' && typeFlag != '\0' && typeFlag != '7' ) ) {
+        return false;
+    }
+
+    uint64_t size = 0;
+    for ( std::size_t i = kSizeOffset; i < kSizeOffset + kSizeLength; ++i ) {
+        const auto digit = header[ i ];
+        if ( digit == ' ' || digit == '\0' ) {
+            if ( i > kSizeOffset ) {
+                break;
+            }
+            continue;
+        }
+        if ( digit < '0' || digit > '7' ) { // e.g., base-256 encoded sizes
+            return false;
+        }
+        size = ( size << 3u ) | static_cast< uint64_t >( digit - '0' );
+    }
+    if ( size != itemSize ) {
+        return false;
+    }
+
+    dataOffset = headerOffset + kTarBlockSize;
+    return true;
+}
+} // namespace
+
+StoredItemCopier::StoredItemCopier( const BitInputArchive& inputArchive )
+    : mInputArchive{ inputArchive },
+      mIsSupported{ !inputArchive.archivePath().empty() &&
+                    ( inputArchive.detectedFormat() == BitFormat::Zip ||
+                      inputArchive.detectedFormat() == BitFormat::Tar ) },
+      mArchiveDescriptor{ -1 } {}
+
+StoredItemCopier::~StoredItemCopier() {
+    if ( mArchiveDescriptor >= 0 ) {
+        ::close( mArchiveDescriptor );
+    }
+}
+
+auto StoredItemCopier::findDataOffset( uint32_t index, uint64_t itemSize, uint64_t& dataOffset ) const -> bool {
+    // For both ZIP and TAR archives, 7-Zip reports the offset of the item's header.
+    const auto headerOffset = mInputArchive.itemProperty( index, BitProperty::Offset );
+    if ( headerOffset.isEmpty() ) {
+        return false;
+    }
+
+    const auto volumeIndex = mInputArchive.itemProperty( index, BitProperty::VolumeIndex );
+    if ( !volumeIndex.isEmpty() && volumeIndex.getUInt64() != 0 ) { // The item is not in the archive file we opened.
+        return false;
+    }
+
+    if ( mInputArchive.detectedFormat() == BitFormat::Zip ) {
+        return zip_data_offset( mArchiveDescriptor, headerOffset.getUInt64(), itemSize, dataOffset );
+    }
+    return tar_data_offset( mArchiveDescriptor, headerOffset.getUInt64(), itemSize, dataOffset );
+}
+
+auto StoredItemCopier::copyItem( uint32_t index, const ProcessedItem& item, CFileOutStream& outStream ) -> bool {
+    // The method is checked first, so that compressed items don't pay for any of the following I/O.
+    if ( !mIsSupported || item.isCompressed() || item.isEncrypted() || !item.hasSize() ) {
+        return false;
+    }
+
+    if ( mArchiveDescriptor < 0 ) {
+        const auto archivePath = tstring_to_path( mInputArchive.archivePath() );
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg, hicpp-signed-bitwise)
+        mArchiveDescriptor = ::open( archivePath.c_str(), O_RDONLY | O_CLOEXEC );
+        if ( mArchiveDescriptor < 0 ) {
+            mIsSupported = false;
+            return false;
+        }
+    }
+
+    uint64_t dataOffset = 0;
+    if ( !findDataOffset( index, item.size(), dataOffset ) ) {
+        return false;
+    }
+
+    /* Items without a CRC (e.g., the TAR ones) are copied kernel-side, which can also reflink their data.
+     * Unlike 7-Zip's decoders, the copy doesn't check the item's data, so we check its CRC (if any) ourselves:
+     * in this case, the data must pass through user space anyway, so we read it once, checking and writing it. */
+    uint32_t dataCrc = 0;
+    const bool isCopied = item.hasCrc() ?
+                          copy_with_crc32( mArchiveDescriptor, dataOffset, item.size(), outStream, dataCrc ) :
+                          outStream.copyFrom( mArchiveDescriptor, dataOffset, item.size() );
+    if ( !isCopied ) {
+        // The copy failed (e.g., copy_file_range is not supported by the filesystem): we undo the partial copy.
+        clear_output( outStream );
+        return false;
+    }
+
+    if ( item.hasCrc() && dataCrc != item.crc() ) {
+        // The corrupted data must not be left in the output file.
+        clear_output( outStream );
+        throw BitException( "Failed to extract the archive",
+                            make_error_code( OperationResult::CRCError ),
+                            path_to_tstring( outStream.path() ) );
+    }
+    return true;
+}
+#else
+StoredItemCopier::StoredItemCopier( const BitInputArchive& inputArchive )
+    : mInputArchive{ inputArchive }, mIsSupported{ false }, mArchiveDescriptor{ -1 } {}
+
+StoredItemCopier::~StoredItemCopier() = default;
+
+auto StoredItemCopier::findDataOffset( uint32_t /*index*/,
+                                       uint64_t /*itemSize*/,
+                                       uint64_t& /*dataOffset*/ ) const -> bool {
+    return false;
+}
+
+auto StoredItemCopier::copyItem( uint32_t /*index*/,
+                                 const ProcessedItem& /*item*/,
+                                 CFileOutStream& /*outStream*/ ) -> bool {
+    return false;
+}
+#endif
+
+} // namespace bit7z
@@ -0,0 +1,63 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef STOREDITEMCOPIER_HPP
+#define STOREDITEMCOPIER_HPP
+
+#include <cstdint>
+
+#include "bitinputarchive.hpp"
+#include "internal/cfileoutstream.hpp"
+#include "internal/processeditem.hpp"
+
+namespace bit7z {
+
+/**
+ * Copies the data of the items stored without compression in an archive file directly to the output files,
+ * without passing through 7-Zip's decoders and buffers (i.e., kernel-side, where supported).
+ */
+class StoredItemCopier final {
+    public:
+        explicit StoredItemCopier( const BitInputArchive& inputArchive );
+
+        StoredItemCopier( const StoredItemCopier& ) = delete;
+
+        StoredItemCopier( StoredItemCopier&& ) = delete;
+
+        auto operator=( const StoredItemCopier& ) -> StoredItemCopier& = delete;
+
+        auto operator=( StoredItemCopier&& ) -> StoredItemCopier& = delete;
+
+        ~StoredItemCopier();
+
+        /**
+         * Copies the data of the given item to the output file stream, if the item is stored uncompressed
+         * at a known offset of the archive file.
+         *
+         * Items without a CRC (e.g., the TAR ones) are copied kernel-side; the other ones are read only once,
+         * computing their CRC while writing them, so that checking the CRC doesn't read the item's data twice.
+         *
+         * @return true if the data of the item has been copied, false if the item must be extracted normally
+         *         (in which case, the output stream is left empty).
+         *
+         * @throws BitException if the copied data doesn't match the CRC of the item (the output stream is left empty).
+         */
+        auto copyItem( uint32_t index, const ProcessedItem& item, CFileOutStream& outStream ) -> bool;
+
+    private:
+        const BitInputArchive& mInputArchive;
+        bool mIsSupported;
+        int mArchiveDescriptor;
+
+        BIT7Z_NODISCARD auto findDataOffset( uint32_t index, uint64_t itemSize, uint64_t& dataOffset ) const -> bool;
+};
+
+}  // namespace bit7z
+
+#endif //STOREDITEMCOPIER_HPP
@@ -12,6 +12,7 @@
 
 #include "internal/cstdoutstream.hpp"
 #include "internal/streamextractcallback.hpp"
+#include "internal/stringutil.hpp"
 #include "internal/util.hpp"
 
 using namespace std;
@@ -33,16 +34,8 @@ auto StreamExtractCallback::getOutStream( uint32_t index, ISequentialOutStream**
     }
 
     // Get Name
-    const BitPropVariant prop = itemProperty( index, BitProperty::Path );
-    tstring fullPath;
-
-    if ( prop.isEmpty() ) {
-        fullPath = kEmptyFileAlias;
-    } else if ( prop.isString() ) {
-        fullPath = prop.getString();
-    } else {
-        return E_FAIL;
-    }
+    const fs::path& itemPath = item( index ).path();
+    const tstring fullPath = itemPath.empty() ? tstring{ kEmptyFileAlias } : path_to_tstring( itemPath );
 
     if ( mHandler.fileCallback() ) {
         mHandler.fileCallback()( fullPath );
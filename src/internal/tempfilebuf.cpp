@@ -0,0 +1,68 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <random>
+#include <sstream>
+
+#include "bitexception.hpp"
+#include "internal/stringutil.hpp"
+#include "internal/tempfilebuf.hpp"
+
+namespace bit7z {
+
+namespace {
+auto unique_temp_path( const fs::path& directory ) -> fs::path {
+    std::random_device randomDevice;
+    std::mt19937_64 generator{ ( static_cast< uint64_t >( randomDevice() ) << 32u ) | randomDevice() };
+
+    std::error_code error;
+    fs::path tempDirectory = directory;
+    if ( tempDirectory.empty() ) {
+        tempDirectory = fs::temp_directory_path( error );
+        if ( error ) {
+            throw BitException( "Failed to create the temporary file", error );
+        }
+    }
+
+    fs::path result;
+    do {
+        std::ostringstream fileName;
+        fileName << "bit7z_" << std::hex << generator() << ".tmp";
+        result = tempDirectory / fileName.str();
+    } while ( fs::exists( result, error ) );
+    return result;
+}
+} // namespace
+
+TempFileBuf::TempFileBuf( const fs::path& directory ) : mPath{ unique_temp_path( directory ) } {
+    constexpr auto kOpenMode = std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary;
+    if ( open( mPath, kOpenMode ) == nullptr ) {
+        throw BitException( "Failed to create the temporary file",
+                            std::make_error_code( std::errc::io_error ),
+                            path_to_tstring( mPath ) );
+    }
+#ifndef _WIN32
+    // The open file remains accessible after its path is removed.
+    std::error_code error;
+    fs::remove( mPath, error );
+#endif
+}
+
+TempFileBuf::~TempFileBuf() {
+    close();
+#ifdef _WIN32
+    std::error_code error;
+    fs::remove( mPath, error );
+#endif
+}
+
+} // namespace bit7z
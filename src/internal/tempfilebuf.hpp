@@ -0,0 +1,40 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef TEMPFILEBUF_HPP
+#define TEMPFILEBUF_HPP
+
+#include "internal/fs.hpp"
+
+namespace bit7z {
+
+/* A file buffer over a new temporary file, which is deleted when the buffer is destroyed
+ * (on POSIX systems, the file is unlinked as soon as it is opened, so it is never left behind). */
+class TempFileBuf final : public fs::filebuf {
+    public:
+        /* Creates a new temporary file in the given directory (or in the system's temporary directory, if empty). */
+        explicit TempFileBuf( const fs::path& directory = {} );
+
+        TempFileBuf( const TempFileBuf& ) = delete;
+
+        TempFileBuf( TempFileBuf&& ) = delete;
+
+        auto operator=( const TempFileBuf& ) -> TempFileBuf& = delete;
+
+        auto operator=( TempFileBuf&& ) -> TempFileBuf& = delete;
+
+        ~TempFileBuf() override;
+
+    private:
+        fs::path mPath;
+};
+
+}  // namespace bit7z
+
+#endif // TEMPFILEBUF_HPP
@@ -0,0 +1,104 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <catch2/catch.hpp>
+
+#include "utils/filesystem.hpp"
+#include "utils/shared_lib.hpp"
+
+#include <bit7z/bitarchivecache.hpp>
+#include <bit7z/bitexception.hpp>
+#include <bit7z/bitformat.hpp>
+
+using namespace bit7z;
+using namespace bit7z::test;
+using namespace bit7z::test::filesystem;
+
+TEST_CASE( "BitArchiveCache: Leasing the same archive twice opens it only once", "[bitarchivecache]" ) {
+    static const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "multiple_items" };
+
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    BitArchiveCache cache{ lib };
+
+    {
+        const auto firstLease = cache.lease( BIT7Z_STRING( "multiple_items.7z" ), BitFormat::SevenZip );
+        REQUIRE( cache.misses() == 1 );
+        REQUIRE( cache.hits() == 0 );
+        REQUIRE( cache.size() == 1 );
+
+        // Each lease has the exclusive use of its reader, so concurrent leases of the same archive open new readers.
+        const auto secondLease = cache.lease( BIT7Z_STRING( "multiple_items.7z" ), BitFormat::SevenZip );
+        REQUIRE( cache.misses() == 2 );
+        REQUIRE( cache.size() == 1 );
+        REQUIRE( &secondLease.reader() != &firstLease.reader() );
+        REQUIRE( cache.memoryUsage() == 0 ); // Only the idle readers are kept by the cache.
+    }
+    REQUIRE( cache.memoryUsage() > 0 );
+
+    // The ended leases gave their readers back to the cache, and different paths to the same file share them.
+    const auto thirdLease = cache.lease( BIT7Z_STRING( "../multiple_items/multiple_items.7z" ), BitFormat::SevenZip );
+    REQUIRE( cache.misses() == 2 );
+    REQUIRE( cache.hits() == 1 );
+    REQUIRE( cache.size() == 1 );
+    REQUIRE( thirdLease->itemsCount() > 0 );
+
+    // A different password identifies a different cached archive.
+    const auto passwordLease = cache.lease( BIT7Z_STRING( "multiple_items.7z" ),
+                                            BitFormat::SevenZip,
+                                            BIT7Z_STRING( "password" ) );
+    REQUIRE( cache.misses() == 3 );
+    REQUIRE( cache.size() == 2 );
+
+    REQUIRE_THROWS_AS( cache.lease( BIT7Z_STRING( "non_existing.7z" ), BitFormat::SevenZip ), BitException );
+}
+
+TEST_CASE( "BitArchiveCache: Evicting the least recently used archives", "[bitarchivecache]" ) {
+    static const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "multiple_items" };
+
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    BitArchiveCache cache{ lib, 2 };
+
+    const auto leaseArchive = [&cache]( const tstring& archive, const BitInFormat& format ) {
+        const auto lease = cache.lease( archive, format );
+        REQUIRE( lease->itemsCount() > 0 );
+    };
+
+    leaseArchive( BIT7Z_STRING( "multiple_items.7z" ), BitFormat::SevenZip );
+    leaseArchive( BIT7Z_STRING( "multiple_items.zip" ), BitFormat::Zip );
+    REQUIRE( cache.size() == 2 );
+    REQUIRE( cache.misses() == 2 );
+
+    // Using the 7z archive again, so that the zip archive becomes the least recently used one.
+    leaseArchive( BIT7Z_STRING( "multiple_items.7z" ), BitFormat::SevenZip );
+    REQUIRE( cache.hits() == 1 );
+
+    leaseArchive( BIT7Z_STRING( "multiple_items.tar" ), BitFormat::Tar );
+    REQUIRE( cache.size() == 2 );
+    leaseArchive( BIT7Z_STRING( "multiple_items.7z" ), BitFormat::SevenZip );
+    REQUIRE( cache.hits() == 2 );
+
+    // The evicted archive is opened again.
+    leaseArchive( BIT7Z_STRING( "multiple_items.zip" ), BitFormat::Zip );
+    REQUIRE( cache.misses() == 4 );
+
+    cache.setMemoryBudget( 0 );
+    REQUIRE( cache.size() == 1 ); // The most recently used archive is kept.
+
+    {
+        // An evicted archive is still usable through its existing lease, and it is closed when the lease ends.
+        const auto lease = cache.lease( BIT7Z_STRING( "multiple_items.zip" ), BitFormat::Zip );
+        cache.clear();
+        REQUIRE( cache.size() == 0 );
+        REQUIRE( lease->itemsCount() > 0 );
+    }
+    REQUIRE( cache.size() == 0 );
+    REQUIRE( cache.memoryUsage() == 0 );
+}
@@ -14,11 +14,15 @@
 #include "utils/archive.hpp"
 #include "utils/filesystem.hpp"
 #include "utils/format.hpp"
+#include "utils/multiple_items.hpp"
 #include "utils/shared_lib.hpp"
 
 #include <bit7z/bitarchivereader.hpp>
+#include <bit7z/bitarchivewriter.hpp>
+#include <bit7z/bitentryreader.hpp>
 #include <bit7z/bitexception.hpp>
 #include <bit7z/bitformat.hpp>
+#include <bit7z/bititemstream.hpp>
 #include <internal/stringutil.hpp>
 #include <internal/windows.hpp>
 
@@ -143,21 +147,6 @@ struct SingleFileArchive : public TestInputArchive {
         : TestInputArchive{ std::move( extension ), format, packedSize, single_file_content() } {}
 };
 
-using stream_t = fs::ifstream;
-
-// Note: we cannot use value semantic and return the archive due to old GCC versions not supporting movable fstreams.
-void getInputArchive( const fs::path& path, tstring& archive ) {
-    archive = path_to_tstring( path );
-}
-
-void getInputArchive( const fs::path& path, buffer_t& archive ) {
-    archive = load_file( path );
-}
-
-void getInputArchive( const fs::path& path, stream_t& archive ) {
-    archive.open( path, std::ios::binary );
-}
-
 template< typename T >
 using is_filesystem_archive = std::is_same< bit7z::tstring, typename std::decay< T >::type >;
 
@@ -236,11 +225,6 @@ TEMPLATE_TEST_CASE( "BitArchiveReader: Reading archives containing multiple file
     }
 }
 
-struct MultipleItemsArchive : public TestInputArchive {
-    MultipleItemsArchive( std::string extension, const BitInFormat& format, std::size_t packedSize )
-        : TestInputArchive{ std::move( extension ), format, packedSize, multiple_items_content() } {}
-};
-
 TEMPLATE_TEST_CASE( "BitArchiveReader: Reading archives containing multiple items (files and folders)",
                     "[bitarchivereader]", tstring, buffer_t, stream_t ) {
     static const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "multiple_items" };
@@ -581,10 +565,281 @@ TEMPLATE_TEST_CASE( "BitArchiveReader: Checking consistency between items() and
         for ( const auto& iteratedItem : info ) {
             const auto& archivedItem = archiveItems[ iteratedItem.index() ];
             REQUIRE_ITEM_EQUAL( archivedItem, iteratedItem );
+
+            const auto foundItem = info.find( archivedItem.path() );
+            REQUIRE( foundItem != info.cend() );
+            REQUIRE( foundItem->index() == archivedItem.index() );
         }
     }
 }
 
+TEMPLATE_TEST_CASE( "BitArchiveReader: Checking consistency between items() and itemsTable()",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        const auto archiveItems = info.items();
+
+        SECTION( "All the columns" ) {
+            const auto table = info.itemsTable();
+            REQUIRE( table.columns() == ItemsTableColumns::All );
+            REQUIRE( table.itemsCount() == archiveItems.size() );
+            for ( const auto& archivedItem : archiveItems ) {
+                const auto index = archivedItem.index();
+                REQUIRE( table.isDir( index ) == archivedItem.isDir() );
+                REQUIRE( table.path( index ) == archivedItem.path() );
+                REQUIRE( table.size( index ) == archivedItem.size() );
+                REQUIRE( table.packSize( index ) == archivedItem.packSize() );
+                REQUIRE( table.crc( index ) == archivedItem.crc() );
+                REQUIRE( table.attributes( index ) == archivedItem.attributes() );
+                REQUIRE( table.isEncrypted( index ) == archivedItem.isEncrypted() );
+            }
+            REQUIRE_THROWS( table.path( table.itemsCount() ) );
+        }
+
+        SECTION( "Only some columns" ) {
+            const auto table = info.itemsTable( ItemsTableColumns::Path | ItemsTableColumns::Size );
+            REQUIRE( table.itemsCount() == archiveItems.size() );
+            REQUIRE( table.packSizes().empty() );
+            REQUIRE( table.crcs().empty() );
+            for ( const auto& archivedItem : archiveItems ) {
+                const auto index = archivedItem.index();
+                REQUIRE( table.path( index ) == archivedItem.path() );
+                REQUIRE( table.size( index ) == archivedItem.size() );
+                REQUIRE( table.packSize( index ) == 0 );
+            }
+        }
+    } );
+}
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Checking consistency between items() and prefetchedItems()",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        const auto archiveItems = info.items();
+
+        // Note: a small window, so that the items are loaded in more than one window.
+        const uint32_t windowSize = GENERATE( 1u, 3u, BitPrefetchedItems::kDefaultWindowSize );
+        const auto prefetchedItems = info.prefetchedItems( ItemsTableColumns::All, windowSize );
+        REQUIRE( prefetchedItems.windowSize() == windowSize );
+
+        uint32_t itemsCount = 0;
+        for ( const auto& item : prefetchedItems ) {
+            REQUIRE( item.index() == itemsCount );
+            const auto& archivedItem = archiveItems[ item.index() ];
+            REQUIRE( item.isDir() == archivedItem.isDir() );
+            REQUIRE( item.path() == archivedItem.path() );
+            REQUIRE( item.size() == archivedItem.size() );
+            REQUIRE( item.packSize() == archivedItem.packSize() );
+            REQUIRE( item.crc() == archivedItem.crc() );
+            REQUIRE( item.attributes() == archivedItem.attributes() );
+            REQUIRE( item.isEncrypted() == archivedItem.isEncrypted() );
+            ++itemsCount;
+        }
+        REQUIRE( itemsCount == info.itemsCount() );
+
+        // Accessing the items out of order reloads the window when needed.
+        auto first = prefetchedItems.begin();
+        auto second = std::next( first );
+        REQUIRE( second->path() == archiveItems[ 1 ].path() );
+        REQUIRE( first->path() == archiveItems[ 0 ].path() );
+    } );
+}
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Checking consistency between items() and summary()",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        uint32_t foldersCount = 0;
+        uint64_t size = 0;
+        std::map< tstring, BitItemsStats > extensions;
+        for ( const auto& item : info ) {
+            if ( item.isDir() ) {
+                ++foldersCount;
+                continue;
+            }
+            size += item.size();
+            auto& stats = extensions[ item.extension() ];
+            ++stats.filesCount;
+            stats.size += item.size();
+        }
+
+        const auto& summary = info.summary();
+        REQUIRE( &summary == &info.summary() );
+        REQUIRE( summary.foldersCount == foldersCount );
+        REQUIRE( summary.filesCount == info.itemsCount() - foldersCount );
+        REQUIRE( summary.size == size );
+        REQUIRE( summary.encryptedFilesCount == 0 );
+        REQUIRE( summary.extensions.size() == extensions.size() );
+        for ( const auto& extension : extensions ) {
+            const auto stats = summary.extensions.find( extension.first );
+            REQUIRE( stats != summary.extensions.end() );
+            REQUIRE( stats->second.filesCount == extension.second.filesCount );
+            REQUIRE( stats->second.size == extension.second.size );
+        }
+
+        uint32_t methodsFilesCount = 0;
+        for ( const auto& method : summary.methods ) {
+            methodsFilesCount += method.second.filesCount;
+        }
+        REQUIRE( methodsFilesCount == summary.filesCount );
+
+        REQUIRE( info.foldersCount() == summary.foldersCount );
+        REQUIRE( info.filesCount() == summary.filesCount );
+        REQUIRE( info.size() == summary.size );
+        REQUIRE( info.packSize() == summary.packSize );
+        REQUIRE_FALSE( info.hasEncryptedItems() );
+        REQUIRE_FALSE( info.isEncrypted() );
+    } );
+}
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Reading an item through a seekable BitItemStream",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        std::map< tstring, buffer_t > expectedBuffers;
+        info.extractTo( expectedBuffers );
+
+        // With a zero maximum memory size, the items not read directly are decoded to a temporary file.
+        const auto maxMemorySize = GENERATE( as< uint64_t >(), 0, uint64_t{ BitItemStream::kDefaultMaxMemorySize } );
+        for ( const auto& item : info ) {
+            if ( item.isDir() ) {
+                continue;
+            }
+            const auto& expectedBuffer = expectedBuffers[ item.path() ];
+
+            BitItemStream itemStream{ info, item.index(), maxMemorySize };
+            REQUIRE( itemStream.size() == expectedBuffer.size() );
+
+            const buffer_t content{ std::istreambuf_iterator< char >( itemStream ),
+                                    std::istreambuf_iterator< char >() };
+            REQUIRE( content == expectedBuffer );
+
+            const auto middle = static_cast< std::ptrdiff_t >( expectedBuffer.size() / 2 );
+            itemStream.clear();
+            itemStream.seekg( middle );
+            REQUIRE( itemStream.tellg() == middle );
+            const buffer_t secondHalf{ std::istreambuf_iterator< char >( itemStream ),
+                                       std::istreambuf_iterator< char >() };
+            REQUIRE( secondHalf == buffer_t( expectedBuffer.cbegin() + middle, expectedBuffer.cend() ) );
+
+            itemStream.clear();
+            itemStream.seekg( 0, std::ios::end );
+            REQUIRE( static_cast< uint64_t >( itemStream.tellg() ) == expectedBuffer.size() );
+        }
+    } );
+}
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Continuing the extraction after the items that fail",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    static const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "encrypted" };
+
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+
+    TestType inputArchive{};
+    getInputArchive( "encrypted.aes256.zip", inputArchive );
+
+    // With a wrong password, the extraction of every encrypted file fails.
+    BitArchiveReader info( lib, inputArchive, BitFormat::Zip, BIT7Z_STRING( "wrongpassword" ) );
+    std::size_t encryptedFiles = 0;
+    for ( const auto& item : info ) {
+        if ( !item.isDir() && item.isEncrypted() ) {
+            ++encryptedFiles;
+        }
+    }
+    REQUIRE( encryptedFiles > 1 );
+
+    SECTION( "Aborting at the first item that fails" ) {
+        REQUIRE( info.errorPolicy() == ErrorPolicy::Abort );
+        try {
+            info.test();
+            FAIL( "The test of the archive should have failed" );
+        } catch ( const BitException& ex ) {
+            REQUIRE( ex.failedFiles().empty() );
+        }
+    }
+
+    SECTION( "Continuing after the items that fail" ) {
+        info.setErrorPolicy( ErrorPolicy::Continue );
+
+        try {
+            info.test();
+            FAIL( "The test of the archive should have failed" );
+        } catch ( const BitException& ex ) {
+            REQUIRE( ex.failedFiles().size() == encryptedFiles );
+        }
+
+        std::map< tstring, buffer_t > outBuffers;
+        try {
+            info.extractTo( outBuffers );
+            FAIL( "The extraction of the archive should have failed" );
+        } catch ( const BitException& ex ) {
+            REQUIRE( ex.failedFiles().size() == encryptedFiles );
+            for ( const auto& failedFile : ex.failedFiles() ) {
+                REQUIRE( failedFile.second );
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Reading the archive entries sequentially with a BitEntryReader",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        std::map< tstring, buffer_t > expectedBuffers;
+        info.extractTo( expectedBuffers );
+
+        SECTION( "Reading all the entries" ) {
+            BitEntryReader reader{ info, 1000 };
+            std::map< tstring, buffer_t > readBuffers;
+            while ( reader.nextEntry() ) {
+                REQUIRE( reader.entry().path == info.itemAt( reader.entry().index ).path() );
+                auto& readBuffer = readBuffers[ reader.entry().path ];
+                buffer_t chunk( 333 );
+                std::size_t readSize = 0;
+                while ( ( readSize = reader.read( chunk.data(), chunk.size() ) ) > 0 ) {
+                    readBuffer.insert( readBuffer.end(), chunk.cbegin(), chunk.cbegin() + readSize );
+                }
+                REQUIRE( readBuffer.size() == reader.entry().size );
+            }
+            REQUIRE_FALSE( reader.nextEntry() );
+            REQUIRE( readBuffers == expectedBuffers );
+        }
+
+        SECTION( "Skipping the content of the entries" ) {
+            BitEntryReader reader{ info, 1000 };
+            std::size_t entriesCount = 0;
+            while ( reader.nextEntry() ) {
+                ++entriesCount;
+            }
+            REQUIRE( entriesCount == expectedBuffers.size() );
+        }
+
+        SECTION( "Closing the reader before the end of the entries" ) {
+            BitEntryReader reader{ info, 1000 };
+            REQUIRE( reader.nextEntry() );
+            reader.close();
+            REQUIRE_FALSE( reader.nextEntry() );
+        }
+    } );
+}
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Listing directories and subtrees",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        REQUIRE( info.listDirectory( BIT7Z_STRING( "" ) ).size() == 6 );
+        REQUIRE( info.subtree( BIT7Z_STRING( "" ) ).size() == info.itemsCount() );
+
+        const auto folderEntries = info.listDirectory( BIT7Z_STRING( "folder" ) );
+        REQUIRE( folderEntries.size() == 3 );
+        for ( const auto& entry : folderEntries ) {
+            REQUIRE( entry.index != BitDirectoryEntry::kNoItem );
+            REQUIRE( entry.isDir == info.isItemFolder( entry.index ) );
+        }
+        REQUIRE( info.subtree( BIT7Z_STRING( "folder" ) ).size() == 6 );
+        REQUIRE( info.subtree( BIT7Z_STRING( "folder/subfolder2" ) ).size() == 3 );
+        REQUIRE( info.subtree( BIT7Z_STRING( "folder/subfolder2/" ) ).size() == 3 );
+
+        REQUIRE( info.listDirectory( BIT7Z_STRING( "empty" ) ).empty() );
+        REQUIRE( info.listDirectory( BIT7Z_STRING( "non-existing" ) ).empty() );
+        REQUIRE( info.subtree( BIT7Z_STRING( "non-existing" ) ).empty() );
+    } );
+}
+
 TEMPLATE_TEST_CASE( "BitArchiveReader: Reading invalid archives",
                     "[bitarchivereader]", tstring, buffer_t, stream_t ) {
     static const TestDirectory testDir{ fs::path{ test_archives_dir } / "testing" };
@@ -1168,6 +1423,92 @@ TEMPLATE_TEST_CASE( "BitInputArchive: Reading a nested zip archive",
     }
 }
 
+TEMPLATE_TEST_CASE( "BitInputArchive: Opening the archives nested in another archive without extracting them",
+                    "[bitinputarchive]", tstring, buffer_t, stream_t ) {
+    const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "nested" };
+
+    const fs::path arcFileName = "multiple_nested2.tar";
+
+    TestType inputArchive{};
+    getInputArchive( arcFileName, inputArchive );
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    const BitArchiveReader parentReader( lib, inputArchive, BitFormat::Tar );
+
+    std::size_t nestedArchives = 0;
+    for ( const auto& item : parentReader ) {
+        const BitInFormat* nestedFormat = nullptr;
+        if ( item.extension() == BIT7Z_STRING( "zip" ) ) {
+            nestedFormat = &BitFormat::Zip;
+        } else if ( item.extension() == BIT7Z_STRING( "7z" ) ) {
+            nestedFormat = &BitFormat::SevenZip;
+        } else {
+            continue;
+        }
+        ++nestedArchives;
+
+        buffer_t nestedBuffer;
+        parentReader.extractTo( nestedBuffer, item.index() );
+        const BitArchiveReader expectedReader( lib, nestedBuffer, *nestedFormat );
+
+        const BitArchiveReader nestedReader( lib, parentReader, item.index(), *nestedFormat );
+        REQUIRE( nestedReader.archivePath().empty() );
+        REQUIRE( nestedReader.itemsCount() == expectedReader.itemsCount() );
+        REQUIRE_NOTHROW( nestedReader.test() );
+
+        std::map< tstring, buffer_t > expectedBuffers;
+        expectedReader.extractTo( expectedBuffers );
+        std::map< tstring, buffer_t > nestedBuffers;
+        nestedReader.extractTo( nestedBuffers );
+        REQUIRE( nestedBuffers == expectedBuffers );
+
+        // The nested archive is not on the filesystem, so its items must be decoded rather than copied from it.
+        const fs::path outDir = fs::temp_directory_path() / "bit7z_nested_extraction";
+        fs::remove_all( outDir );
+        REQUIRE_NOTHROW( nestedReader.extractTo( path_to_tstring( outDir ) ) );
+        for ( const auto& expectedBuffer : expectedBuffers ) {
+            REQUIRE( load_file( outDir / tstring_to_path( expectedBuffer.first ) ) == expectedBuffer.second );
+        }
+        fs::remove_all( outDir );
+    }
+    REQUIRE( nestedArchives > 0 );
+
+    REQUIRE_THROWS( BitArchiveReader( lib, parentReader, parentReader.itemsCount(), BitFormat::Zip ) );
+}
+
+TEST_CASE( "BitInputArchive: Opening an archive nested in a compressed archive", "[bitinputarchive]" ) {
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+
+    std::map< tstring, buffer_t > expectedBuffers;
+    const std::string text = "The quick brown fox jumps over the lazy dog";
+    expectedBuffers[ BIT7Z_STRING( "text.txt" ) ] = buffer_t( text.cbegin(), text.cend() );
+    expectedBuffers[ BIT7Z_STRING( "zeros.bin" ) ] = buffer_t( 100000, 0 );
+
+    const auto nestedFormat = GENERATE( as< const BitInOutFormat* >(), &BitFormat::Zip, &BitFormat::SevenZip );
+    BitArchiveWriter nestedWriter{ lib, *nestedFormat };
+    for ( const auto& expectedBuffer : expectedBuffers ) {
+        nestedWriter.addFile( expectedBuffer.second, expectedBuffer.first );
+    }
+    buffer_t nestedBuffer;
+    nestedWriter.compressTo( nestedBuffer );
+
+    // The items of a 7z archive cannot be read as direct streams, so the nested archive must be decoded.
+    BitArchiveWriter parentWriter{ lib, BitFormat::SevenZip };
+    parentWriter.addFile( nestedBuffer, BIT7Z_STRING( "nested" ) + tstring{ nestedFormat->extension() } );
+    buffer_t parentBuffer;
+    parentWriter.compressTo( parentBuffer );
+
+    const BitArchiveReader parentReader( lib, parentBuffer, BitFormat::SevenZip );
+    REQUIRE( parentReader.itemsCount() == 1 );
+    const BitArchiveReader nestedReader( lib, parentReader, 0, *nestedFormat );
+    REQUIRE( nestedReader.archivePath().empty() );
+    REQUIRE( nestedReader.itemsCount() == expectedBuffers.size() );
+    REQUIRE_NOTHROW( nestedReader.test() );
+
+    std::map< tstring, buffer_t > nestedBuffers;
+    nestedReader.extractTo( nestedBuffers );
+    REQUIRE( nestedBuffers == expectedBuffers );
+}
+
 #ifdef _WIN32
 TEMPLATE_TEST_CASE( "BitInputArchive: Reading a zip archive using a different encoding",
                     "[bitinputarchive]", tstring, buffer_t, stream_t ) {
@@ -0,0 +1,68 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <catch2/catch.hpp>
+
+#include "utils/filesystem.hpp"
+#include "utils/shared_lib.hpp"
+
+#include <bit7z/bitarchivesession.hpp>
+#include <bit7z/bitformat.hpp>
+
+#include <thread>
+
+using namespace bit7z;
+using namespace bit7z::test;
+using namespace bit7z::test::filesystem;
+
+TEST_CASE( "BitArchiveSession: Extracting items concurrently from multiple threads", "[bitarchivesession]" ) {
+    static const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "multiple_items" };
+
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+
+    const BitArchiveSession session{ lib, BIT7Z_STRING( "multiple_items.7z" ), BitFormat::SevenZip };
+    REQUIRE( session.readersCount() == 1 );
+
+    const BitArchiveReader reader{ lib, BIT7Z_STRING( "multiple_items.7z" ), BitFormat::SevenZip };
+    REQUIRE( session.itemsCount() == reader.itemsCount() );
+
+    const auto& items = session.items();
+    std::vector< std::vector< byte_t > > expectedContents( session.itemsCount() );
+    for ( uint32_t index = 0; index < session.itemsCount(); ++index ) {
+        REQUIRE( items.path( index ) == reader.itemAt( index ).path() );
+        if ( !items.isDir( index ) ) {
+            reader.extractTo( expectedContents[ index ], index );
+        }
+    }
+
+    constexpr auto kThreadsCount = 4u;
+    std::vector< std::vector< std::vector< byte_t > > > threadsContents( kThreadsCount );
+    std::vector< std::thread > threads;
+    for ( unsigned threadIndex = 0; threadIndex < kThreadsCount; ++threadIndex ) {
+        threads.emplace_back( [ &session, &items, &contents = threadsContents[ threadIndex ] ]() {
+            contents.resize( session.itemsCount() );
+            for ( uint32_t index = 0; index < session.itemsCount(); ++index ) {
+                if ( !items.isDir( index ) ) {
+                    session.extractTo( contents[ index ], index );
+                }
+            }
+        } );
+    }
+    for ( auto& thread : threads ) {
+        thread.join();
+    }
+
+    for ( const auto& contents : threadsContents ) {
+        REQUIRE( contents == expectedContents );
+    }
+    REQUIRE( session.readersCount() >= 1 );
+    REQUIRE( session.readersCount() <= kThreadsCount );
+}
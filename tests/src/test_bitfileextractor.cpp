@@ -12,15 +12,540 @@
 
 #include <catch2/catch.hpp>
 
+#include "utils/filesystem.hpp"
 #include "utils/shared_lib.hpp"
 
+#include <bit7z/bitexception.hpp>
+#include <bit7z/bitfilecompressor.hpp>
 #include <bit7z/bitfileextractor.hpp>
+#include <internal/stringutil.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
 
 using namespace bit7z;
+using namespace bit7z::test;
+using namespace bit7z::test::filesystem;
 
 TEST_CASE( "BitFileExtractor: TODO", "[bitfileextractor]" ) {
     const Bit7zLibrary lib{ test::sevenzip_lib_path() };
 
     const BitFileExtractor extractor{lib, BitFormat::SevenZip};
     REQUIRE( extractor.extractionFormat() == BitFormat::SevenZip ); // Just a placeholder test.
-}
\ No newline at end of file
+}
+
+#ifdef BIT7Z_TESTS_FILESYSTEM
+
+namespace {
+// A temporary directory, removed with all its content when going out of scope.
+class TempTestDirectory final {
+    public:
+        explicit TempTestDirectory( const fs::path& name ) : mPath{ fs::temp_directory_path() / name } {
+            std::error_code error;
+            fs::remove_all( mPath, error );
+            fs::create_directories( mPath );
+        }
+
+        TempTestDirectory( const TempTestDirectory& ) = delete;
+
+        TempTestDirectory( TempTestDirectory&& ) = delete;
+
+        auto operator=( const TempTestDirectory& ) -> TempTestDirectory& = delete;
+
+        auto operator=( TempTestDirectory&& ) -> TempTestDirectory& = delete;
+
+        ~TempTestDirectory() {
+            std::error_code error;
+            fs::remove_all( mPath, error );
+        }
+
+        BIT7Z_NODISCARD auto path() const -> const fs::path& {
+            return mPath;
+        }
+
+    private:
+        fs::path mPath;
+};
+
+auto random_content( std::size_t size, unsigned int seed ) -> buffer_t {
+    std::mt19937 generator{ seed };
+    std::uniform_int_distribution< int > distribution{ 0, 255 };
+    buffer_t content( size );
+    for ( auto& byte : content ) {
+        byte = static_cast< byte_t >( distribution( generator ) );
+    }
+    return content;
+}
+
+void write_file( const fs::path& filePath, const buffer_t& content ) {
+    fs::create_directories( filePath.parent_path() );
+    fs::ofstream outFile{ filePath, std::ios::binary };
+    REQUIRE( outFile.is_open() );
+    // NOLINTNEXTLINE(*-pro-type-reinterpret-cast)
+    outFile.write( reinterpret_cast< const char* >( content.data() ), static_cast< std::streamsize >( content.size() ) );
+}
+
+constexpr auto kSparseBlockSize = 4096u;
+constexpr auto kTextContent = "Hello, bit7z!\n";
+
+// Content made of some data, a long run of zeros, some other data, and a trailing run of zeros.
+auto sparse_content() -> buffer_t {
+    constexpr auto kDataSize = 16u * kSparseBlockSize;
+    constexpr auto kZerosSize = 256u * kSparseBlockSize;
+    buffer_t content = random_content( kDataSize, 1 );
+    content.resize( content.size() + kZerosSize, 0 );
+    const buffer_t data = random_content( kDataSize, 2 );
+    content.insert( content.end(), data.cbegin(), data.cend() );
+    content.resize( content.size() + kZerosSize, 0 );
+    return content;
+}
+
+// Creates the test input files: files of different sizes (including an empty one), in nested folders.
+void create_input_files( const fs::path& inputDir ) {
+    write_file( inputDir / "random.bin", random_content( 300000, 3 ) );
+    write_file( inputDir / "empty.txt", {} );
+    const std::string text = kTextContent;
+    write_file( inputDir / "text.txt", buffer_t( text.cbegin(), text.cend() ) );
+    write_file( inputDir / "folder" / "sparse.bin", sparse_content() );
+    write_file( inputDir / "folder" / "subfolder" / "small.bin", random_content( 100, 4 ) );
+}
+
+// Creates an archive, in the given format, with the content of the given directory.
+void create_archive( const Bit7zLibrary& lib,
+                     const BitInOutFormat& format,
+                     const fs::path& inputDir,
+                     const fs::path& archivePath,
+                     BitCompressionLevel level = BitCompressionLevel::Normal ) {
+    BitFileCompressor compressor{ lib, format };
+    compressor.setCompressionLevel( level );
+    compressor.compressDirectoryContents( path_to_tstring( inputDir ), path_to_tstring( archivePath ) );
+}
+
+// Checks that all the files in the input directory have been extracted, with the same content, to the output one.
+void require_same_files( const fs::path& inputDir, const fs::path& outputDir ) {
+    for ( const auto& entry : fs::recursive_directory_iterator( inputDir ) ) {
+        const fs::path relativePath = entry.path().lexically_relative( inputDir );
+        INFO( "Checking the file " << relativePath.string() )
+        const fs::path outputPath = outputDir / relativePath;
+        if ( entry.is_directory() ) {
+            REQUIRE( fs::is_directory( outputPath ) );
+            continue;
+        }
+        REQUIRE( fs::is_regular_file( outputPath ) );
+        REQUIRE( fs::file_size( outputPath ) == fs::file_size( entry.path() ) );
+        REQUIRE( load_file( outputPath ) == load_file( entry.path() ) );
+    }
+}
+
+// Flips a byte of the given content in the given file (e.g., to corrupt the data of an item stored in an archive).
+void corrupt_file( const fs::path& filePath, const std::string& content ) {
+    buffer_t fileContent = load_file( filePath );
+    const auto position = std::search( fileContent.begin(), fileContent.end(), content.cbegin(), content.cend() );
+    REQUIRE( position != fileContent.end() );
+    *position ^= 0xFFu;
+    write_file( filePath, fileContent );
+}
+
+auto modified_seconds( const fs::path& filePath ) -> std::chrono::seconds::rep {
+    return std::chrono::duration_cast< std::chrono::seconds >( fs::last_write_time( filePath ).time_since_epoch() )
+           .count();
+}
+} // namespace
+
+TEST_CASE( "BitFileExtractor: Extracting the files with their modified time and permissions",
+           "[bitfileextractor]" ) {
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    const TempTestDirectory testDir{ "bit7z_test_metadata" };
+
+    const fs::path inputDir = testDir.path() / "input";
+    create_input_files( inputDir );
+
+    // Giving the input files a modified time and permissions different from the ones of new files.
+    const auto oneYear = std::chrono::hours{ 24 * 365 };
+    for ( const auto& entry : fs::recursive_directory_iterator( inputDir ) ) {
+        if ( entry.is_regular_file() ) {
+            fs::last_write_time( entry.path(), fs::last_write_time( entry.path() ) - oneYear );
+        }
+    }
+    const fs::path readOnlyFile = inputDir / "text.txt";
+    fs::permissions( readOnlyFile, fs::perms::owner_read | fs::perms::group_read, fs::perm_options::replace );
+    const fs::path executableFile = inputDir / "folder" / "subfolder" / "small.bin";
+    fs::permissions( executableFile, fs::perms::owner_exec, fs::perm_options::add );
+
+    const auto testFormat = GENERATE( as< const BitInOutFormat* >(), &BitFormat::Tar, &BitFormat::SevenZip );
+    const fs::path archivePath = testDir.path() / "archive";
+    create_archive( lib, *testFormat, inputDir, archivePath );
+
+    const fs::path outputDir = testDir.path() / "output";
+    const BitFileExtractor extractor{ lib, *testFormat };
+    extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+    require_same_files( inputDir, outputDir );
+
+    for ( const auto& entry : fs::recursive_directory_iterator( inputDir ) ) {
+        if ( !entry.is_regular_file() ) {
+            continue;
+        }
+        const fs::path outputPath = outputDir / entry.path().lexically_relative( inputDir );
+        INFO( "Checking the file " << outputPath.string() )
+        // Archive formats store the modified times with different precisions, so we compare them in seconds.
+        REQUIRE( modified_seconds( outputPath ) == modified_seconds( entry.path() ) );
+#ifndef _WIN32
+        REQUIRE( fs::status( outputPath ).permissions() == fs::status( entry.path() ).permissions() );
+#endif
+    }
+
+    // Restoring the permissions, so that the test directory can be removed.
+    fs::permissions( readOnlyFile, fs::perms::owner_write, fs::perm_options::add );
+    fs::permissions( outputDir / "text.txt", fs::perms::owner_write, fs::perm_options::add );
+}
+
+TEST_CASE( "BitFileExtractor: Extracting the files through a pool of writer threads", "[bitfileextractor]" ) {
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    const TempTestDirectory testDir{ "bit7z_test_writer_pool" };
+
+    const fs::path inputDir = testDir.path() / "input";
+    create_input_files( inputDir );
+    const auto testFormat = GENERATE( as< const BitInOutFormat* >(), &BitFormat::Zip, &BitFormat::SevenZip );
+    const fs::path archivePath = testDir.path() / "archive";
+    create_archive( lib, *testFormat, inputDir, archivePath );
+
+    BitFileExtractor extractor{ lib, *testFormat };
+    extractor.setWriterThreads( 2 );
+    // Smaller than the biggest file, which is written directly; the other files are written by the pool.
+    extractor.setWriterMemoryLimit( 512 * 1024 );
+
+    const fs::path outputDir = testDir.path() / "output";
+    extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+    require_same_files( inputDir, outputDir );
+
+    SECTION( "Failing to write an existing file" ) {
+        extractor.setOverwriteMode( OverwriteMode::None );
+        REQUIRE_THROWS_AS( extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) ),
+                           BitException );
+        require_same_files( inputDir, outputDir );
+    }
+
+    SECTION( "Continuing after the files that fail to be written" ) {
+        // Every file already exists, so all the writes fail, including the ones still pending at the end.
+        extractor.setOverwriteMode( OverwriteMode::None );
+        extractor.setErrorPolicy( ErrorPolicy::Continue );
+        try {
+            extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+            FAIL( "The extraction of the existing files should have failed" );
+        } catch ( const BitException& ex ) {
+            // Each failure must be reported once, with the path of the file that failed.
+            std::vector< fs::path > failedPaths;
+            for ( const auto& failedFile : ex.failedFiles() ) {
+                failedPaths.push_back( tstring_to_path( failedFile.first ) );
+            }
+            std::vector< fs::path > inputFiles;
+            for ( const auto& entry : fs::recursive_directory_iterator( inputDir ) ) {
+                if ( entry.is_regular_file() ) {
+                    inputFiles.push_back( entry.path().lexically_relative( inputDir ) );
+                }
+            }
+            std::sort( failedPaths.begin(), failedPaths.end() );
+            std::sort( inputFiles.begin(), inputFiles.end() );
+            REQUIRE( failedPaths == inputFiles );
+        }
+        require_same_files( inputDir, outputDir );
+    }
+
+    SECTION( "Overwriting the existing files" ) {
+        write_file( outputDir / "random.bin", random_content( 10, 5 ) );
+        extractor.setOverwriteMode( OverwriteMode::Overwrite );
+        REQUIRE_NOTHROW( extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) ) );
+        require_same_files( inputDir, outputDir );
+    }
+}
+
+TEST_CASE( "BitFileExtractor: Extracting the files as sparse files", "[bitfileextractor]" ) {
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    const TempTestDirectory testDir{ "bit7z_test_sparse" };
+
+    const fs::path inputDir = testDir.path() / "input";
+    create_input_files( inputDir );
+    const auto testFormat = GENERATE( as< const BitInOutFormat* >(), &BitFormat::Zip, &BitFormat::SevenZip );
+    const fs::path archivePath = testDir.path() / "archive";
+    create_archive( lib, *testFormat, inputDir, archivePath );
+
+    BitFileExtractor extractor{ lib, *testFormat };
+    extractor.setSparseExtraction( true );
+
+    const fs::path outputDir = testDir.path() / "output";
+    extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+    require_same_files( inputDir, outputDir );
+
+#ifndef _WIN32
+    // The runs of zeros of the file must have been left as holes, so the file uses less space than its size.
+    struct stat fileStat{};
+    const fs::path sparseFile = outputDir / "folder" / "sparse.bin";
+    REQUIRE( ::stat( sparseFile.c_str(), &fileStat ) == 0 );
+    constexpr auto kStatBlockSize = 512;
+    REQUIRE( static_cast< uint64_t >( fileStat.st_blocks ) * kStatBlockSize < fs::file_size( sparseFile ) / 2 );
+#endif
+}
+
+TEST_CASE( "BitFileExtractor: Extracting the files through a memory mapping", "[bitfileextractor]" ) {
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    const TempTestDirectory testDir{ "bit7z_test_memory_mapped" };
+
+    const fs::path inputDir = testDir.path() / "input";
+    create_input_files( inputDir );
+    const auto testFormat = GENERATE( as< const BitInOutFormat* >(), &BitFormat::Zip, &BitFormat::SevenZip );
+    const fs::path archivePath = testDir.path() / "archive";
+    create_archive( lib, *testFormat, inputDir, archivePath );
+
+    // Only the files at least as big as the threshold are mapped, so the extraction mixes mapped and normal writes.
+    const auto threshold = GENERATE( as< uint64_t >(), 1, kSparseBlockSize );
+    BitFileExtractor extractor{ lib, *testFormat };
+    extractor.setMemoryMappedThreshold( threshold );
+
+    // The output files must have the same content and (once the mappings are released) size as the input ones.
+    const fs::path outputDir = testDir.path() / "output";
+    extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+    require_same_files( inputDir, outputDir );
+
+    SECTION( "Overwriting bigger files" ) {
+        write_file( outputDir / "text.txt", random_content( 1024 * 1024, 7 ) );
+        extractor.setOverwriteMode( OverwriteMode::Overwrite );
+        extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+        require_same_files( inputDir, outputDir );
+    }
+}
+
+TEST_CASE( "BitFileExtractor: Extracting the files stored without compression", "[bitfileextractor]" ) {
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    const TempTestDirectory testDir{ "bit7z_test_stored" };
+
+    const fs::path inputDir = testDir.path() / "input";
+    create_input_files( inputDir );
+    const auto testFormat = GENERATE( as< const BitInOutFormat* >(), &BitFormat::Zip, &BitFormat::Tar );
+    const fs::path archivePath = testDir.path() / "archive";
+    create_archive( lib, *testFormat, inputDir, archivePath, BitCompressionLevel::None );
+
+    // The writer pool must journal its files like the extracting thread does.
+    const auto writerThreads = GENERATE( as< uint32_t >(), 0, 2 );
+    BitFileExtractor extractor{ lib, *testFormat };
+    extractor.setWriterThreads( writerThreads );
+    const fs::path outputDir = testDir.path() / "output";
+
+    SECTION( "Extracting an archive" ) {
+        extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+        require_same_files( inputDir, outputDir );
+    }
+
+    SECTION( "Extracting an archive with a corrupted item" ) {
+        if ( *testFormat != BitFormat::Zip ) { // TAR archives have no CRC to detect the corruption.
+            return;
+        }
+
+        const fs::path corruptedArchivePath = testDir.path() / "corrupted";
+        fs::copy_file( archivePath, corruptedArchivePath );
+        corrupt_file( corruptedArchivePath, kTextContent );
+
+        const fs::path journalPath = testDir.path() / "extraction.journal";
+        extractor.setErrorPolicy( ErrorPolicy::Continue );
+        extractor.setExtractionJournal( path_to_tstring( journalPath ) );
+        try {
+            extractor.extract( path_to_tstring( corruptedArchivePath ), path_to_tstring( outputDir ) );
+            FAIL( "The extraction of the corrupted item should have failed" );
+        } catch ( const BitException& ex ) {
+            REQUIRE( ex.failedFiles().size() == 1 );
+            REQUIRE( ex.failedFiles().front().first == BIT7Z_STRING( "text.txt" ) );
+        }
+        REQUIRE( fs::exists( journalPath ) );
+        REQUIRE( load_file( outputDir / "random.bin" ) == load_file( inputDir / "random.bin" ) );
+#ifdef __linux__
+        if ( writerThreads == 0 ) { // The corrupted data copied from the archive must not be left in the output file.
+            REQUIRE( fs::file_size( outputDir / "text.txt" ) == 0 );
+        }
+#endif
+
+        // Repairing the archive in place, keeping its size and modified time, so that its journal is resumed.
+        const auto corruptedModifiedTime = fs::last_write_time( corruptedArchivePath );
+        write_file( corruptedArchivePath, load_file( archivePath ) );
+        fs::last_write_time( corruptedArchivePath, corruptedModifiedTime );
+
+        // The corrupted item must not have been recorded as completed, so resuming the extraction rewrites it.
+        std::vector< tstring > resumedFiles;
+        extractor.setFileCallback( [&resumedFiles]( const tstring& filePath ) {
+            resumedFiles.push_back( filePath );
+        } );
+        extractor.setOverwriteMode( OverwriteMode::Overwrite );
+        extractor.extract( path_to_tstring( corruptedArchivePath ), path_to_tstring( outputDir ) );
+        require_same_files( inputDir, outputDir );
+        REQUIRE_FALSE( fs::exists( journalPath ) );
+        REQUIRE( std::find( resumedFiles.cbegin(), resumedFiles.cend(), BIT7Z_STRING( "text.txt" ) ) !=
+                 resumedFiles.cend() );
+        REQUIRE( std::find( resumedFiles.cbegin(), resumedFiles.cend(), BIT7Z_STRING( "random.bin" ) ) ==
+                 resumedFiles.cend() );
+    }
+}
+
+TEST_CASE( "BitFileExtractor: Resuming an interrupted extraction", "[bitfileextractor]" ) {
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    const TempTestDirectory testDir{ "bit7z_test_resume" };
+
+    const fs::path inputDir = testDir.path() / "input";
+    create_input_files( inputDir );
+    const auto testFormat = GENERATE( as< const BitInOutFormat* >(), &BitFormat::Zip, &BitFormat::SevenZip );
+    const fs::path archivePath = testDir.path() / "archive";
+    create_archive( lib, *testFormat, inputDir, archivePath );
+
+    const auto writerThreads = GENERATE( as< uint32_t >(), 0, 2 );
+    BitFileExtractor extractor{ lib, *testFormat };
+    extractor.setWriterThreads( writerThreads );
+    const fs::path journalPath = testDir.path() / "extraction.journal";
+    extractor.setExtractionJournal( path_to_tstring( journalPath ) );
+
+    // Interrupting the extraction when it reaches its third file.
+    std::vector< tstring > extractedFiles;
+    extractor.setFileCallback( [&extractedFiles]( const tstring& filePath ) {
+        if ( extractedFiles.size() == 2 ) {
+            throw std::runtime_error( "Extraction interrupted" );
+        }
+        extractedFiles.push_back( filePath );
+    } );
+    const fs::path outputDir = testDir.path() / "output";
+    REQUIRE_THROWS_AS( extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) ),
+                       BitException );
+    REQUIRE( extractedFiles.size() == 2 );
+    REQUIRE( fs::exists( journalPath ) );
+
+    // A completed file modified after the interruption must not be skipped when resuming the extraction.
+    const tstring modifiedFile = extractedFiles.back();
+    write_file( outputDir / tstring_to_path( modifiedFile ), random_content( 10, 8 ) );
+
+    std::vector< tstring > resumedFiles;
+    extractor.setFileCallback( [&resumedFiles]( const tstring& filePath ) {
+        resumedFiles.push_back( filePath );
+    } );
+    extractor.setOverwriteMode( OverwriteMode::Overwrite );
+    extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+    require_same_files( inputDir, outputDir );
+    REQUIRE_FALSE( fs::exists( journalPath ) );
+
+    // Only the completed file that was not modified must have been skipped.
+    const tstring skippedFile = extractedFiles.front();
+    REQUIRE( std::find( resumedFiles.cbegin(), resumedFiles.cend(), skippedFile ) == resumedFiles.cend() );
+    REQUIRE( std::find( resumedFiles.cbegin(), resumedFiles.cend(), modifiedFile ) != resumedFiles.cend() );
+    std::size_t inputFilesCount = 0;
+    for ( const auto& entry : fs::recursive_directory_iterator( inputDir ) ) {
+        if ( entry.is_regular_file() ) {
+            ++inputFilesCount;
+        }
+    }
+    REQUIRE( resumedFiles.size() == inputFilesCount - 1 );
+}
+
+TEST_CASE( "BitFileExtractor: Discarding the journal of a different archive", "[bitfileextractor]" ) {
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    const TempTestDirectory testDir{ "bit7z_test_stale_journal" };
+
+    // Two TAR archives (i.e., without CRCs) with the same items, having the same sizes but a different content.
+    const fs::path firstInputDir = testDir.path() / "first";
+    write_file( firstInputDir / "first.bin", random_content( 1000, 9 ) );
+    write_file( firstInputDir / "second.bin", random_content( 2000, 10 ) );
+    const fs::path firstArchivePath = testDir.path() / "first.tar";
+    create_archive( lib, BitFormat::Tar, firstInputDir, firstArchivePath );
+
+    const fs::path secondInputDir = testDir.path() / "second";
+    write_file( secondInputDir / "first.bin", random_content( 1000, 11 ) );
+    write_file( secondInputDir / "second.bin", random_content( 2000, 12 ) );
+    const fs::path secondArchivePath = testDir.path() / "second.tar";
+    create_archive( lib, BitFormat::Tar, secondInputDir, secondArchivePath );
+
+    BitFileExtractor extractor{ lib, BitFormat::Tar };
+    const fs::path journalPath = testDir.path() / "extraction.journal";
+    extractor.setExtractionJournal( path_to_tstring( journalPath ) );
+
+    // Interrupting the extraction of the first archive after its first file.
+    bool isInterrupted = false;
+    extractor.setFileCallback( [&isInterrupted]( const tstring& ) {
+        if ( isInterrupted ) {
+            throw std::runtime_error( "Extraction interrupted" );
+        }
+        isInterrupted = true;
+    } );
+    const fs::path outputDir = testDir.path() / "output";
+    REQUIRE_THROWS_AS( extractor.extract( path_to_tstring( firstArchivePath ), path_to_tstring( outputDir ) ),
+                       BitException );
+    REQUIRE( fs::exists( journalPath ) );
+
+    // The journal must not mark any file of the second archive as completed.
+    extractor.setFileCallback( {} );
+    extractor.setOverwriteMode( OverwriteMode::Overwrite );
+    extractor.extract( path_to_tstring( secondArchivePath ), path_to_tstring( outputDir ) );
+    require_same_files( secondInputDir, outputDir );
+    REQUIRE_FALSE( fs::exists( journalPath ) );
+}
+
+TEST_CASE( "BitFileExtractor: Skipping the unchanged files", "[bitfileextractor]" ) {
+    const Bit7zLibrary lib{ test::sevenzip_lib_path() };
+    const TempTestDirectory testDir{ "bit7z_test_skip_unchanged" };
+
+    const fs::path inputDir = testDir.path() / "input";
+    create_input_files( inputDir );
+    const fs::path archivePath = testDir.path() / "archive.7z";
+    create_archive( lib, BitFormat::SevenZip, inputDir, archivePath );
+
+    BitFileExtractor extractor{ lib, BitFormat::SevenZip };
+    const fs::path outputDir = testDir.path() / "output";
+    extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+
+    // Changing the content of an extracted file, while keeping its size and modified time.
+    const fs::path textFile = outputDir / "text.txt";
+    const auto textModifiedTime = fs::last_write_time( textFile );
+    std::string changedText = kTextContent;
+    changedText.front() = 'J';
+    const buffer_t changedContent( changedText.cbegin(), changedText.cend() );
+    write_file( textFile, changedContent );
+    fs::last_write_time( textFile, textModifiedTime );
+
+    SECTION( "Skipping the files with the same size and modified time" ) {
+        extractor.setOverwriteMode( OverwriteMode::SkipIfUnchanged );
+        extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+        REQUIRE( load_file( textFile ) == changedContent );
+    }
+
+    SECTION( "Overwriting the files with a different modified time" ) {
+        fs::last_write_time( textFile, textModifiedTime + std::chrono::hours{ 1 } );
+        extractor.setOverwriteMode( OverwriteMode::SkipIfUnchanged );
+        extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+        require_same_files( inputDir, outputDir );
+    }
+
+    SECTION( "Overwriting the files with a different size" ) {
+        write_file( textFile, random_content( 1024, 6 ) );
+        fs::last_write_time( textFile, textModifiedTime );
+        extractor.setOverwriteMode( OverwriteMode::SkipIfUnchanged );
+        extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+        require_same_files( inputDir, outputDir );
+    }
+
+    SECTION( "Overwriting the files with a different CRC" ) {
+        extractor.setOverwriteMode( OverwriteMode::SkipIfUnchangedCrc );
+        extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+        require_same_files( inputDir, outputDir );
+    }
+
+    SECTION( "Extracting the deleted files" ) {
+        fs::remove( outputDir / "folder" / "subfolder" / "small.bin" );
+        extractor.setOverwriteMode( OverwriteMode::SkipIfUnchanged );
+        extractor.extract( path_to_tstring( archivePath ), path_to_tstring( outputDir ) );
+        REQUIRE( load_file( outputDir / "folder" / "subfolder" / "small.bin" ) ==
+                 load_file( inputDir / "folder" / "subfolder" / "small.bin" ) );
+        REQUIRE( load_file( textFile ) == changedContent );
+    }
+}
+
+#endif
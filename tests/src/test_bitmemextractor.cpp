@@ -12,15 +12,228 @@
 
 #include <catch2/catch.hpp>
 
+#include "utils/multiple_items.hpp"
 #include "utils/shared_lib.hpp"
 
+#include <bit7z/bitarchivereader.hpp>
+#include <bit7z/bitextractionarena.hpp>
+#include <bit7z/bititemcontent.hpp>
+#include <bit7z/bititemsink.hpp>
 #include <bit7z/bitmemextractor.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <stdexcept>
+
 using namespace bit7z;
+using namespace bit7z::test;
 
 TEST_CASE( "BitMemExtractor: TODO", "[bitmemxtractor]" ) {
     const Bit7zLibrary lib{ test::sevenzip_lib_path() };
 
     const BitMemExtractor memExtractor{lib, BitFormat::SevenZip};
     REQUIRE( memExtractor.extractionFormat() == BitFormat::SevenZip ); // Just a placeholder test.
-}
\ No newline at end of file
+}
+
+#ifdef BIT7Z_TESTS_FILESYSTEM
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Extracting multiple items to buffers in a single pass",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        // The files in reverse order, with the first file requested twice.
+        std::vector< uint32_t > indices;
+        for ( uint32_t index = info.itemsCount(); index > 0; --index ) {
+            if ( !info.isItemFolder( index - 1 ) ) {
+                indices.push_back( index - 1 );
+            }
+        }
+        REQUIRE_FALSE( indices.empty() );
+        indices.push_back( indices.front() );
+
+        std::vector< buffer_t > outBuffers;
+        info.extractTo( outBuffers, indices );
+        REQUIRE( outBuffers.size() == indices.size() );
+        for ( std::size_t position = 0; position < indices.size(); ++position ) {
+            buffer_t expectedBuffer;
+            info.extractTo( expectedBuffer, indices[ position ] );
+            REQUIRE( outBuffers[ position ] == expectedBuffer );
+        }
+
+        REQUIRE_THROWS( info.extractTo( outBuffers, { info.itemsCount() } ) );
+    } );
+}
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Extracting items to an arena",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        BitExtractionArena arena;
+        info.extractTo( arena );
+        REQUIRE( arena.itemsCount() == info.filesCount() );
+        REQUIRE( arena.data().size() == info.size() );
+
+        std::map< tstring, buffer_t > expectedBuffers;
+        info.extractTo( expectedBuffers );
+        for ( const auto& entry : arena.entries() ) {
+            REQUIRE( arena.path( entry ) == info.itemAt( entry.index ).path() );
+            const auto expectedBuffer = expectedBuffers.find( arena.path( entry ) );
+            REQUIRE( expectedBuffer != expectedBuffers.end() );
+            const buffer_t itemBuffer( arena.itemData( entry ), arena.itemData( entry ) + entry.size );
+            REQUIRE( itemBuffer == expectedBuffer->second );
+        }
+    } );
+}
+
+namespace {
+struct BufferSink final : public BitItemSink {
+    buffer_t& buffer;
+    bool finished = false;
+
+    explicit BufferSink( buffer_t& outBuffer ) : buffer{ outBuffer } {}
+
+    auto write( const byte_t* data, std::size_t size ) -> bool override {
+        buffer.insert( buffer.end(), data, data + size );
+        return true;
+    }
+
+    void finish() override {
+        finished = true;
+    }
+};
+} // namespace
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Extracting items to the sinks created by a factory",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        std::map< tstring, buffer_t > expectedBuffers;
+        info.extractTo( expectedBuffers );
+
+        std::map< tstring, buffer_t > sinkBuffers;
+        uint32_t skippedItems = 0;
+        info.extractTo( [ & ]( const BitArchiveItemOffset& item ) -> std::unique_ptr< BitItemSink > {
+            if ( item.extension() == BIT7Z_STRING( "pdf" ) ) {
+                ++skippedItems;
+                return nullptr;
+            }
+            return std::unique_ptr< BitItemSink >( new BufferSink( sinkBuffers[ item.path() ] ) );
+        } );
+
+        REQUIRE( sinkBuffers.size() + skippedItems == expectedBuffers.size() );
+        for ( const auto& sinkBuffer : sinkBuffers ) {
+            REQUIRE( sinkBuffer.second == expectedBuffers[ sinkBuffer.first ] );
+        }
+
+        const auto throwingFactory = []( const BitArchiveItemOffset& ) -> std::unique_ptr< BitItemSink > {
+            throw std::logic_error( "user error" );
+        };
+        REQUIRE_THROWS_AS( info.extractTo( throwingFactory ), std::logic_error );
+    } );
+}
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Extracting the prefixes of the items",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        std::map< tstring, buffer_t > expectedBuffers;
+        info.extractTo( expectedBuffers );
+
+        std::vector< uint32_t > indices;
+        for ( const auto& item : info ) {
+            if ( !item.isDir() ) {
+                indices.push_back( item.index() );
+            }
+        }
+        REQUIRE( indices.size() == expectedBuffers.size() );
+        indices.push_back( indices.front() ); // Requesting an item twice.
+
+        const auto prefixSize = GENERATE( as< std::size_t >(), 1, 100, 1024 * 1024 );
+        DYNAMIC_SECTION( "Prefix size: " << prefixSize ) {
+            std::vector< buffer_t > outBuffers;
+            info.extractPrefixes( outBuffers, prefixSize, indices );
+            REQUIRE( outBuffers.size() == indices.size() );
+            for ( std::size_t position = 0; position < indices.size(); ++position ) {
+                const auto& expectedBuffer = expectedBuffers[ info.itemAt( indices[ position ] ).path() ];
+                const auto expectedSize = std::min( prefixSize, expectedBuffer.size() );
+                REQUIRE( outBuffers[ position ] == buffer_t( expectedBuffer.cbegin(),
+                                                             expectedBuffer.cbegin() + expectedSize ) );
+            }
+        }
+    } );
+}
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Extracting a byte range of an item",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        std::map< tstring, buffer_t > expectedBuffers;
+        info.extractTo( expectedBuffers );
+
+        const auto offset = GENERATE( as< uint64_t >(), 0, 10, 1000 );
+        const auto length = GENERATE( as< uint64_t >(), 1, 100, 100000 );
+        for ( const auto& item : info ) {
+            if ( item.isDir() ) {
+                continue;
+            }
+            const auto& expectedBuffer = expectedBuffers[ item.path() ];
+            const uint64_t itemSize = expectedBuffer.size();
+
+            buffer_t rangeBuffer;
+            BufferSink sink{ rangeBuffer };
+            info.extractRange( item.index(), offset, length, sink );
+            REQUIRE( sink.finished );
+
+            const auto rangeStart = std::min( offset, itemSize );
+            const auto rangeEnd = std::min( offset + length, itemSize );
+            REQUIRE( rangeBuffer == buffer_t( expectedBuffer.cbegin() + static_cast< std::ptrdiff_t >( rangeStart ),
+                                              expectedBuffer.cbegin() + static_cast< std::ptrdiff_t >( rangeEnd ) ) );
+        }
+
+        buffer_t rangeBuffer;
+        BufferSink sink{ rangeBuffer };
+        REQUIRE_THROWS( info.extractRange( info.itemsCount(), 0, 100, sink ) );
+    } );
+}
+
+TEMPLATE_TEST_CASE( "BitArchiveReader: Extracting items in memory, spilling the large ones to temporary files",
+                    "[bitarchivereader]", tstring, buffer_t, stream_t ) {
+    test_multiple_items_readers< TestType >( []( const BitArchiveReader& info ) {
+        std::map< tstring, buffer_t > expectedBuffers;
+        info.extractTo( expectedBuffers );
+
+        const auto checkContents = [ & ]( std::map< tstring, BitItemContent >& contents ) {
+            REQUIRE( contents.size() == expectedBuffers.size() );
+            for ( auto& content : contents ) {
+                const auto& expectedBuffer = expectedBuffers[ content.first ];
+                REQUIRE( content.second.size() == expectedBuffer.size() );
+                if ( content.second.isInMemory() ) {
+                    REQUIRE( content.second.buffer() == expectedBuffer );
+                }
+                auto& contentStream = content.second.stream();
+                const buffer_t streamedContent{ std::istreambuf_iterator< char >( contentStream ),
+                                                std::istreambuf_iterator< char >() };
+                REQUIRE( streamedContent == expectedBuffer );
+            }
+        };
+
+        SECTION( "Using an item memory threshold" ) {
+            const auto itemMemoryThreshold = GENERATE( as< uint64_t >(), 0, 1000, 100000 );
+            std::map< tstring, BitItemContent > contents;
+            info.extractTo( contents, itemMemoryThreshold );
+            checkContents( contents );
+            for ( const auto& content : contents ) {
+                REQUIRE( content.second.isInMemory() == ( content.second.size() <= itemMemoryThreshold ) );
+            }
+        }
+
+        SECTION( "Using a memory budget" ) {
+            std::map< tstring, BitItemContent > contents;
+            info.extractTo( contents, std::numeric_limits< uint64_t >::max(), 0 );
+            checkContents( contents );
+            for ( const auto& content : contents ) {
+                REQUIRE( content.second.isInMemory() == ( content.second.size() == 0 ) );
+            }
+        }
+    } );
+}
+
+#endif
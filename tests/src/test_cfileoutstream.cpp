@@ -0,0 +1,73 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifdef BIT7Z_TESTS_FILESYSTEM
+
+#include <catch2/catch.hpp>
+
+#include <internal/cfileoutstream.hpp>
+#include <internal/fs.hpp>
+#include <internal/util.hpp>
+
+#include <iterator>
+
+using namespace bit7z;
+
+namespace {
+auto read_file( const fs::path& filePath ) -> buffer_t {
+    fs::ifstream inFile{ filePath, std::ios::binary };
+    return buffer_t{ std::istreambuf_iterator< char >( inFile ), std::istreambuf_iterator< char >() };
+}
+} // namespace
+
+TEST_CASE( "CFileOutStream: Writing a file through a memory mapping", "[cfileoutstream]" ) {
+    const fs::path filePath = fs::temp_directory_path() / "bit7z_test_mapped_output.bin";
+
+    buffer_t content( 10000 );
+    for ( std::size_t position = 0; position < content.size(); ++position ) {
+        content[ position ] = static_cast< byte_t >( position % 251 );
+    }
+
+    // The mapping is sized to the declared size of the item, which can differ from the size of its actual content.
+    const auto mappedSize = GENERATE_COPY( as< uint64_t >(), content.size() / 2, content.size(), 4 * content.size() );
+    DYNAMIC_SECTION( "Mapping " << mappedSize << " bytes" ) {
+        {
+            auto outStream = bit7z::make_com< CFileOutStream >( filePath, true );
+#ifdef __linux__
+            REQUIRE( outStream->mapOutput( mappedSize ) );
+#else
+            REQUIRE_FALSE( outStream->mapOutput( mappedSize ) );
+#endif
+            const auto halfSize = static_cast< UInt32 >( content.size() / 2 );
+            UInt32 processedSize = 0;
+            REQUIRE( outStream->Write( content.data(), halfSize, &processedSize ) == S_OK );
+            REQUIRE( processedSize == halfSize );
+            REQUIRE( outStream->Write( &content[ halfSize ], halfSize, &processedSize ) == S_OK );
+            REQUIRE( processedSize == halfSize );
+            REQUIRE_FALSE( outStream->fail() );
+#ifndef _WIN32
+            // The mapping is written back and released, and the file truncated to the content actually written.
+            REQUIRE( outStream->completeWrites() );
+            REQUIRE( fs::file_size( filePath ) == content.size() );
+#endif
+        }
+
+        // When the stream is released, the file must be truncated to the content actually written.
+        REQUIRE( fs::file_size( filePath ) == content.size() );
+        REQUIRE( read_file( filePath ) == content );
+
+        std::error_code error;
+        fs::remove( filePath, error );
+    }
+}
+
+#endif
@@ -67,6 +67,12 @@ TEST_CASE( "fsutil: Date conversions", "[fsutil][date functions]" ) {
             auto result = FILETIME_to_file_time_type( testDate.fileTime );
             REQUIRE( as_unix_timestamp( result ) == testDate.dateTime );
         }
+
+        SECTION( "From FILETIME to timespec" ) {
+            auto result = FILETIME_to_timespec( testDate.fileTime );
+            REQUIRE( result.tv_sec == testDate.dateTime );
+            REQUIRE( result.tv_nsec == 0 );
+        }
 #endif
 
         SECTION( "From FILETIME to bit7z::time_type" ) {
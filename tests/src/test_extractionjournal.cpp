@@ -0,0 +1,98 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifdef BIT7Z_TESTS_FILESYSTEM
+
+#include <catch2/catch.hpp>
+
+#include <internal/extractionjournal.hpp>
+#include <internal/fs.hpp>
+
+using namespace bit7z;
+
+TEST_CASE( "ExtractionJournal: Resuming the completed files of an interrupted extraction", "[extractionjournal]" ) {
+    const fs::path journalPath = fs::temp_directory_path() / "bit7z_test_extraction.journal";
+    std::error_code error;
+    fs::remove( journalPath, error );
+
+    constexpr uint32_t kItemsCount = 10;
+    constexpr uint64_t kArchiveId = 0x123456789ABCDEF0;
+    {
+        ExtractionJournal journal{ journalPath, kItemsCount, kArchiveId };
+        uint64_t size = 0;
+        REQUIRE_FALSE( journal.completedSize( 0, 0, size ) );
+
+        journal.recordCompleted( 1, 42, 0xDEADBEEF );
+        journal.recordCompleted( 5, 0, 0 );
+    }
+    REQUIRE( fs::exists( journalPath ) );
+
+    SECTION( "Reopening the journal for the same archive" ) {
+        {
+            // The process was killed while writing the record of a file.
+            fs::ofstream journalFile{ journalPath, std::ios::app };
+            journalFile << "7 1024";
+        }
+
+        ExtractionJournal journal{ journalPath, kItemsCount, kArchiveId };
+        uint64_t size = 0;
+        REQUIRE( journal.completedSize( 1, 0xDEADBEEF, size ) );
+        REQUIRE( size == 42 );
+        REQUIRE_FALSE( journal.completedSize( 1, 0, size ) ); // Different CRC
+        REQUIRE( journal.completedSize( 5, 0, size ) );
+        REQUIRE( size == 0 );
+        REQUIRE_FALSE( journal.completedSize( 7, 0, size ) );
+
+        journal.recordCompleted( 7, 1024, 0 );
+        {
+            const ExtractionJournal resumedJournal{ journalPath, kItemsCount, kArchiveId };
+            REQUIRE( resumedJournal.completedSize( 7, 0, size ) );
+            REQUIRE( size == 1024 );
+            REQUIRE( resumedJournal.completedSize( 1, 0xDEADBEEF, size ) );
+        }
+
+        journal.remove();
+        REQUIRE_FALSE( fs::exists( journalPath ) );
+    }
+
+    SECTION( "Reopening the journal for a different archive with the same number of items" ) {
+        {
+            ExtractionJournal journal{ journalPath, kItemsCount, kArchiveId + 1 };
+            uint64_t size = 0;
+            REQUIRE_FALSE( journal.completedSize( 1, 0xDEADBEEF, size ) );
+            REQUIRE_FALSE( journal.completedSize( 5, 0, size ) );
+        }
+
+        // The journal was started over for the new archive.
+        ExtractionJournal journal{ journalPath, kItemsCount, kArchiveId };
+        uint64_t size = 0;
+        REQUIRE_FALSE( journal.completedSize( 5, 0, size ) );
+        journal.remove();
+    }
+
+    SECTION( "Reopening the journal for a different archive" ) {
+        {
+            ExtractionJournal journal{ journalPath, kItemsCount + 1, kArchiveId };
+            uint64_t size = 0;
+            REQUIRE_FALSE( journal.completedSize( 1, 0xDEADBEEF, size ) );
+            REQUIRE_FALSE( journal.completedSize( 5, 0, size ) );
+        }
+
+        // The journal was started over for the new archive.
+        ExtractionJournal journal{ journalPath, kItemsCount, kArchiveId };
+        uint64_t size = 0;
+        REQUIRE_FALSE( journal.completedSize( 1, 0xDEADBEEF, size ) );
+        journal.remove();
+    }
+}
+
+#endif
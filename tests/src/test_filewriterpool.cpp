@@ -0,0 +1,135 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <bit7z/bitexception.hpp>
+#include <internal/filewriterpool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+
+using namespace bit7z;
+
+namespace {
+constexpr auto kMemoryLimit = 1000u;
+constexpr auto kBlockedTimeout = std::chrono::milliseconds{ 100 };
+} // namespace
+
+TEST_CASE( "FileWriterPool: Bounding the memory used by the buffers", "[filewriterpool]" ) {
+    FileWriterPool pool{ 1, kMemoryLimit };
+
+    std::promise< void > writeAllowed;
+    std::shared_future< void > writeAllowedFuture = writeAllowed.get_future().share();
+    buffer_t buffer = pool.acquireBuffer( 600 );
+    REQUIRE( buffer.capacity() >= 600 );
+    buffer.resize( 600 );
+    pool.submit( std::move( buffer ), 0, BIT7Z_STRING( "first" ), [writeAllowedFuture]( const buffer_t& ) {
+        writeAllowedFuture.wait();
+    } );
+
+    // The submitted buffer is still being written, so there's no memory for a second one.
+    auto acquiredBuffer = std::async( std::launch::async, [&pool]() -> buffer_t {
+        return pool.acquireBuffer( 600 );
+    } );
+    REQUIRE( acquiredBuffer.wait_for( kBlockedTimeout ) == std::future_status::timeout );
+
+    writeAllowed.set_value();
+    buffer = acquiredBuffer.get();
+    REQUIRE( buffer.empty() );
+    REQUIRE( buffer.capacity() >= 600 ); // i.e., the recycled buffer.
+    pool.releaseBuffer( std::move( buffer ) );
+
+    // The recycled buffer is too small, and keeping it would exceed the limit, so it must be released.
+    auto biggerBuffer = std::async( std::launch::async, [&pool]() -> buffer_t {
+        return pool.acquireBuffer( 900 );
+    } );
+    REQUIRE( biggerBuffer.wait_for( kBlockedTimeout ) == std::future_status::ready );
+    buffer = biggerBuffer.get();
+    REQUIRE( buffer.capacity() >= 900 );
+
+    // A buffer bigger than the memory limit is accepted only when no other buffer uses memory.
+    pool.releaseBuffer( std::move( buffer ) );
+    buffer = pool.acquireBuffer( 2 * kMemoryLimit );
+    REQUIRE( buffer.capacity() >= 2 * kMemoryLimit );
+    pool.submit( std::move( buffer ), 1, BIT7Z_STRING( "second" ), []( const buffer_t& ) {} );
+    REQUIRE_NOTHROW( pool.finish() );
+}
+
+TEST_CASE( "FileWriterPool: Failing the writes after a failed one", "[filewriterpool]" ) {
+    FileWriterPool pool{ 1, kMemoryLimit };
+
+    std::promise< void > writeAllowed;
+    std::shared_future< void > writeAllowedFuture = writeAllowed.get_future().share();
+    pool.submit( pool.acquireBuffer( 10 ), 0, BIT7Z_STRING( "failed" ), [writeAllowedFuture]( const buffer_t& ) {
+        writeAllowedFuture.wait();
+        throw BitException( "Failed to write the output file", std::make_error_code( std::errc::no_space_on_device ) );
+    } );
+
+    std::atomic< bool > cancelledWriteExecuted{ false };
+    pool.submit( pool.acquireBuffer( 10 ), 1, BIT7Z_STRING( "cancelled" ),
+                 [&cancelledWriteExecuted]( const buffer_t& ) {
+                     cancelledWriteExecuted = true;
+                 } );
+    writeAllowed.set_value();
+
+    const auto requireFirstError = [&pool]( bool finish ) {
+        try {
+            if ( finish ) {
+                pool.finish();
+            } else {
+                pool.rethrowIfFailed();
+            }
+            FAIL( "The pool should have thrown the error of the failed write" );
+        } catch ( const BitException& ex ) {
+            REQUIRE( ex.code() == std::errc::no_space_on_device );
+        }
+    };
+    requireFirstError( true );
+    REQUIRE_FALSE( cancelledWriteExecuted );
+
+    // The error is kept, so it is reported again.
+    requireFirstError( false );
+    requireFirstError( true );
+}
+
+TEST_CASE( "FileWriterPool: Executing all the writes, reporting the failed ones", "[filewriterpool]" ) {
+    FileWriterPool pool{ 2, kMemoryLimit, false };
+
+    std::atomic< uint32_t > executedWrites{ 0 };
+    const auto failingWrite = [&executedWrites]( const buffer_t& ) {
+        ++executedWrites;
+        throw BitException( "Failed to write the output file", std::make_error_code( std::errc::no_space_on_device ) );
+    };
+    const auto successfulWrite = [&executedWrites]( const buffer_t& ) {
+        ++executedWrites;
+    };
+    pool.submit( pool.acquireBuffer( 10 ), 0, BIT7Z_STRING( "first" ), successfulWrite );
+    pool.submit( pool.acquireBuffer( 10 ), 1, BIT7Z_STRING( "second" ), failingWrite );
+    pool.submit( pool.acquireBuffer( 10 ), 2, BIT7Z_STRING( "third" ), successfulWrite );
+    pool.submit( pool.acquireBuffer( 10 ), 3, BIT7Z_STRING( "fourth" ), failingWrite );
+    pool.wait();
+    REQUIRE( executedWrites == 4 );
+
+    const auto failedWrites = pool.takeFailedWrites();
+    REQUIRE( failedWrites.size() == 2 );
+    REQUIRE( failedWrites[ 0 ].itemIndex == 1 );
+    REQUIRE( failedWrites[ 0 ].itemPath == BIT7Z_STRING( "second" ) );
+    REQUIRE( failedWrites[ 1 ].itemIndex == 3 );
+    REQUIRE( failedWrites[ 1 ].itemPath == BIT7Z_STRING( "fourth" ) );
+    REQUIRE_THROWS_AS( std::rethrow_exception( failedWrites[ 1 ].error ), BitException );
+
+    // The failures were taken, so they are not reported again.
+    REQUIRE( pool.takeFailedWrites().empty() );
+    REQUIRE_NOTHROW( pool.finish() );
+}
@@ -0,0 +1,79 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) 2014-2023 Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef MULTIPLE_ITEMS_HPP
+#define MULTIPLE_ITEMS_HPP
+
+#include "archive.hpp"
+#include "filesystem.hpp"
+#include "shared_lib.hpp"
+
+#include <bit7z/bit7zlibrary.hpp>
+#include <bit7z/bitarchivereader.hpp>
+#include <internal/stringutil.hpp>
+
+#include <catch2/catch.hpp>
+
+namespace bit7z { // NOLINT(modernize-concat-nested-namespaces)
+namespace test {
+
+#ifdef BIT7Z_TESTS_DATA_DIR
+
+using stream_t = fs::ifstream;
+
+struct MultipleItemsArchive : public TestInputArchive {
+    MultipleItemsArchive( std::string extension, const BitInFormat& format, std::size_t packedSize )
+        : TestInputArchive{ std::move( extension ), format, packedSize, filesystem::multiple_items_content() } {}
+};
+
+// Note: we cannot use value semantic and return the archive due to old GCC versions not supporting movable fstreams.
+inline void getInputArchive( const fs::path& path, tstring& archive ) {
+    archive = path_to_tstring( path );
+}
+
+inline void getInputArchive( const fs::path& path, buffer_t& archive ) {
+    archive = filesystem::load_file( path );
+}
+
+inline void getInputArchive( const fs::path& path, stream_t& archive ) {
+    archive.open( path, std::ios::binary );
+}
+
+/**
+ * Runs the given test on a reader of each "multiple_items" test archive in the 7z, tar, and zip formats
+ * (each one in its own section), opened from an input of the given type (a path, a buffer, or a stream).
+ */
+template< typename Input, typename Test >
+void test_multiple_items_readers( const Test& test ) {
+    const filesystem::TestDirectory testDir{ fs::path{ filesystem::test_archives_dir } /
+                                             "extraction" / "multiple_items" };
+
+    const Bit7zLibrary lib{ sevenzip_lib_path() };
+
+    const auto testArchive = GENERATE( as< MultipleItemsArchive >(),
+                                        MultipleItemsArchive{ "7z", BitFormat::SevenZip, 563797 },
+                                        MultipleItemsArchive{ "tar", BitFormat::Tar, 617472 },
+                                        MultipleItemsArchive{ "zip", BitFormat::Zip, 564097 } );
+
+    DYNAMIC_SECTION( "Archive format: " << testArchive.extension() ) {
+        const fs::path arcFileName = "multiple_items." + testArchive.extension();
+
+        Input inputArchive{};
+        getInputArchive( arcFileName, inputArchive );
+        const BitArchiveReader info( lib, inputArchive, testArchive.format() );
+        test( info );
+    }
+}
+
+#endif
+
+} // namespace test
+} // namespace bit7z
+
+#endif //MULTIPLE_ITEMS_HPP